@@ -21,6 +21,73 @@ using namespace PathFind;
 
 //-----------------------------------------------------------------------------
 
+namespace
+{
+    /** Computes the paths inside clusters with search engines and
+        statistics per thread.
+    */
+    class ClusterPathsTask
+        : public ThreadPool::Task
+    {
+    public:
+        ClusterPathsTask(vector<Cluster>& clusters,
+                         const StatisticsCollection& statistics,
+                         bool useJumpPointSearch, int numberThreads);
+
+        ~ClusterPathsTask();
+
+        /** Add the statistics of all threads. */
+        void addStatistics(StatisticsCollection& statistics) const;
+
+        void run(int item, int thread);
+
+    private:
+        vector<Cluster>& m_clusters;
+
+        vector<StatisticsCollection> m_statistics;
+
+        vector<SearchPool*> m_searchPools;
+    };
+
+    ClusterPathsTask::ClusterPathsTask(vector<Cluster>& clusters,
+                                       const StatisticsCollection& statistics,
+                                       bool useJumpPointSearch,
+                                       int numberThreads)
+        : m_clusters(clusters),
+          m_statistics(numberThreads, statistics)
+    {
+        for (int i = 0; i < numberThreads; ++i)
+        {
+            m_statistics[i].clear();
+            m_searchPools.push_back(new SearchPool());
+            m_searchPools.back()->setUseJumpPointSearch(useJumpPointSearch);
+        }
+    }
+
+    ClusterPathsTask::~ClusterPathsTask()
+    {
+        for (vector<SearchPool*>::iterator i = m_searchPools.begin();
+             i != m_searchPools.end(); ++i)
+            delete *i;
+    }
+
+    void ClusterPathsTask::addStatistics(StatisticsCollection& statistics)
+        const
+    {
+        for (vector<StatisticsCollection>::const_iterator i =
+                 m_statistics.begin(); i != m_statistics.end(); ++i)
+            statistics.add(*i);
+    }
+
+    void ClusterPathsTask::run(int item, int thread)
+    {
+        m_clusters[item].computePaths(m_statistics[thread],
+                                      *m_searchPools[thread]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 AbsTilingNodeInfo::AbsTilingNodeInfo()
     : m_id(-1),
       m_level(-1),
@@ -342,11 +409,12 @@ void AbsTiling::linkEntrancesAndClusters()
 void AbsTiling::computeClusterPaths()
 {
     cerr << "Computing internal cluster paths...\n";
-    for (unsigned int i = 0; i < m_clusters.size(); i++)
-    {
-        Cluster &cluster = m_clusters[i];
-        cluster.computePaths(m_preStatistics[0]);
-    }
+    // Clusters only read and write their own members
+    ClusterPathsTask task(m_clusters, m_preStatistics[0],
+                          m_searchPool.getUseJumpPointSearch(),
+                          m_threadPool.getNumberThreads());
+    m_threadPool.run(task, m_clusters.size());
+    task.addStatistics(m_preStatistics[0]);
 }
 
 void AbsTiling::addOutEdge(int initNodeId, int destNodeId, int cost, int level, bool inter)
@@ -479,7 +547,8 @@ int AbsTiling::insertStal(int nodeId, int nodeRow, int nodeCol, int start)
                                       nodeCol - cluster.getHorizOrigin(),
                                       1));
     // update paths
-    cluster.updatePaths(cluster.getNrEntrances() - 1, m_stStatistics[0]);
+    cluster.updatePaths(cluster.getNrEntrances() - 1, m_stStatistics[0],
+                        m_searchPool);
     // create new node to the abstract graph
     m_graph.addNode(absNodeId,
                     AbsTilingNodeInfo(absNodeId, 1,
@@ -646,8 +715,7 @@ void AbsTiling::init(AbsType type, int clusterSize, int rows, int columns)
     m_rows = rows;
     m_columns = columns;
     m_clusterSize = clusterSize;
-    for (int i = 0; i < rows*columns; i++)
-        m_absNodeIds[i] = NO_NODE;
+    m_absNodeIds.assign(rows * columns, NO_NODE);
 }
 
 bool AbsTiling::isValidNodeId(int nodeId) const
@@ -691,7 +759,8 @@ void AbsTiling::absPath2llPath2(const vector<int> &absPath, vector<int>& result,
                 vector<int> localPath = 
                     cluster.computePath(cluster.getLocalCenter(index1),
                                       cluster.getLocalCenter(index2),
-                                      m_abInterSearchStatistics[0]);
+                                      m_abInterSearchStatistics[0],
+                                      m_searchPool);
                 assert(localPath.size() > 1);
                 for (vector<int>::const_iterator j = localPath.begin();
                      j != localPath.end(); ++j)
@@ -719,21 +788,15 @@ void AbsTiling::absPath2llPath2(const vector<int> &absPath, vector<int>& result,
 }
 
 
-void AbsTiling::convertVisitedNodes(const vector<char> &absNodes, vector<char> &llVisitedNodes, int size)
+void AbsTiling::convertVisitedNodes(const vector<int> &absNodeIds, vector<char> &llVisitedNodes, int size)
 {
-    llVisitedNodes.resize(size);
-    for (vector<char>::iterator i = llVisitedNodes.begin();
-         i != llVisitedNodes.end(); ++i)
-        *i = ' ';
-
-    for (unsigned int i = 0; i < absNodes.size(); i++)
-        if (absNodes[i] != ' ')
-        {
-            const AbsTilingNodeInfo& currentNodeInfo = m_graph.getNodeInfo(i);
-            int currentAbsNodeId = currentNodeInfo.getCenterId();
-            llVisitedNodes[currentAbsNodeId] = '+';
-        }
-
+    llVisitedNodes.assign(size, ' ');
+    for (unsigned int i = 0; i < absNodeIds.size(); i++)
+    {
+        const AbsTilingNodeInfo& currentNodeInfo = m_graph.getNodeInfo(absNodeIds[i]);
+        int currentAbsNodeId = currentNodeInfo.getCenterId();
+        llVisitedNodes[currentAbsNodeId] = '+';
+    }
 }
 
 void AbsTiling::printFormatted(ostream& o) const
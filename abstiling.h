@@ -184,6 +184,29 @@ namespace PathFind
 
         void setType(Tiling::Type type);
 
+        /** Use JumpPointSearch for the searches inside clusters, if the
+            tiling type supports it.
+            The default is AStar.
+        */
+        void setUseJumpPointSearch(bool enable)
+        {
+            m_searchPool.setUseJumpPointSearch(enable);
+        }
+
+        /** Set the number of threads for computing the paths inside
+            clusters and, in HTiling, the edges of the higher levels.
+            Each thread uses its own search engines and statistics, which
+            are added to the pre-processing statistics at the end. The
+            cpu_time statistics measure the CPU time of the process, so
+            with more than one thread they include the other threads.
+            The default is 1.
+            @throws Error, if numberThreads is smaller than 1.
+        */
+        void setNumberThreads(int numberThreads)
+        {
+            m_threadPool = ThreadPool(numberThreads);
+        }
+
         void clearStatistics();
 
         AbsType getType()
@@ -214,7 +237,11 @@ namespace PathFind
 
         void absPath2llPath2(const vector<int> &absPath, vector<int>& result, int cols);
 
-        void convertVisitedNodes(const vector<char> &absNodes, vector<char> &llVisitedNodes, int size);
+        /** Get char labels of the low level nodes for the centers of
+            visited abstract nodes, as returned by
+            Search::getVisitedNodeIds().
+        */
+        void convertVisitedNodes(const vector<int> &absNodeIds, vector<char> &llVisitedNodes, int size);
 
         // insert a new node, such as start or target, to the abstract graph and
         // returns the id of the newly created node in the abstract graph
@@ -266,7 +293,10 @@ namespace PathFind
 
         int m_nrAbsNodes;
 
-        int m_absNodeIds[1000000];
+        /** Abstract node of each tiling node, NO_NODE if none.
+            Has rows * columns entries.
+        */
+        vector<int> m_absNodeIds;
 
         StatisticsCollection m_storageStatistics[MAX_LEVELS];
 
@@ -282,6 +312,11 @@ namespace PathFind
 
         StatisticsCollection m_postStatistics;
 
+        /** Engines for the searches on the abstract graph and clusters. */
+        SearchPool m_searchPool;
+
+        ThreadPool m_threadPool;
+
         int m_clusterSize;
 
         int m_maxLevel;
@@ -0,0 +1,323 @@
+//-----------------------------------------------------------------------------
+/** @file arastar.cpp
+    @see arastar.h
+*/
+//-----------------------------------------------------------------------------
+
+#include "arastar.h"
+
+#include <assert.h>
+#include <iomanip>
+#include <sstream>
+#include <time.h>
+#include "error.h"
+
+using namespace std;
+using namespace PathFind;
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+    /** Bounds closer to 1 than this are rounded to 1. */
+    const double BOUND_EPSILON = 1e-9;
+
+    double computeRoundBound(double initialBound, double boundStep,
+                             int round)
+    {
+        double bound = initialBound - round * boundStep;
+        if (bound < 1 + BOUND_EPSILON)
+            return 1;
+        return bound;
+    }
+
+    int computeNumberRounds(double initialBound, double boundStep)
+    {
+        if (initialBound < 1)
+            throw Error("ARAStar: initial bound must be at least 1.");
+        if (boundStep <= 0)
+            throw Error("ARAStar: bound step must be positive.");
+        int numberRounds = 1;
+        while (computeRoundBound(initialBound, boundStep, numberRounds - 1)
+               > 1)
+            ++numberRounds;
+        return numberRounds;
+    }
+
+    string getRoundName(int round, const string& name)
+    {
+        ostringstream buffer;
+        buffer << "round" << setw(2) << setfill('0') << (round + 1) << '_'
+               << name;
+        return buffer.str();
+    }
+
+    /** Check if an entry of the open list is not outdated. */
+    bool isOpenEntry(const NodeStateArray& nodeStates, int nodeId, int g)
+    {
+        return (nodeStates.getState(nodeId) == NodeStateArray::OPEN
+                && nodeStates.getG(nodeId) == g);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+ARAStar::Relaxer::Relaxer(ARAStar& search, int nodeId, int g)
+    : m_search(search),
+      m_nodeId(nodeId),
+      m_g(g),
+      m_numberSuccessors(0)
+{
+}
+
+bool ARAStar::Relaxer::visit(int target, int cost)
+{
+    ++m_numberSuccessors;
+    m_search.relax(m_nodeId, m_g, target, cost);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+ARAStar::ARAStar(double initialBound, double boundStep)
+    : m_isAborted(false),
+      m_initialBound(initialBound),
+      m_boundStep(boundStep),
+      m_numberRounds(computeNumberRounds(initialBound, boundStep)),
+      m_bound(initialBound),
+      m_pathBound(0),
+      m_pathCost(-1),
+      m_target(NO_NODE),
+      m_env(0),
+      m_nodesExpanded(0),
+      m_nodesVisited(0),
+      m_numberNodes(0),
+      m_openSize(0),
+      m_maxOpenSize(0),
+      m_statistics(createStatistics()),
+      m_branchingFactor(m_statistics.get("branching_factor")),
+      m_cpuTimeStatistics(m_statistics.get("cpu_time")),
+      m_nodesExpandedStatistics(m_statistics.get("nodes_expanded")),
+      m_nodesVisitedStatistics(m_statistics.get("nodes_visited")),
+      m_openLengthStatistics(m_statistics.get("open_length")),
+      m_openMaxStatistics(m_statistics.get("open_max")),
+      m_pathCostStatistics(m_statistics.get("path_cost")),
+      m_pathLengthStatistics(m_statistics.get("path_length")),
+      m_roundsStatistics(m_statistics.get("rounds")),
+      m_roundStatistics(m_numberRounds)
+{
+    for (int i = 0; i < m_numberRounds; ++i)
+    {
+        RoundStatistics& roundStatistics = m_roundStatistics[i];
+        roundStatistics.m_bound =
+            &m_statistics.get(getRoundName(i, "bound"));
+        roundStatistics.m_nodesExpanded =
+            &m_statistics.get(getRoundName(i, "nodes_expanded"));
+        roundStatistics.m_pathCost =
+            &m_statistics.get(getRoundName(i, "path_cost"));
+    }
+}
+
+inline int ARAStar::getWeightedHeuristic(int nodeId) const
+{
+    int heuristic = m_env->getHeuristic(nodeId, m_target);
+    return static_cast<int>(m_bound * heuristic);
+}
+
+StatisticsCollection ARAStar::createStatistics()
+{
+    StatisticsCollection collection = createBasicStatistics();
+    collection.create("rounds");
+    for (int i = 0; i < m_numberRounds; ++i)
+    {
+        collection.create(getRoundName(i, "bound"));
+        collection.create(getRoundName(i, "nodes_expanded"));
+        collection.create(getRoundName(i, "path_cost"));
+    }
+    return collection;
+}
+
+bool ARAStar::findPath(const Environment& env, int start, int target)
+{
+    assert(env.isValidNodeId(start));
+    assert(env.isValidNodeId(target));
+    clock_t startTime = clock();
+    m_statistics.clear();
+    m_nodesExpanded = 0;
+    m_nodesVisited = 0;
+    m_env = &env;
+    m_numberNodes = env.getNumberNodes();
+    m_target = target;
+    clearTrace();
+    m_path.clear();
+    m_pathCost = -1;
+    m_pathBound = 0;
+    m_isAborted = false;
+    findPathAra(start);
+    double timeDiff =
+        static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
+    m_cpuTimeStatistics.add(timeDiff);
+    m_nodesExpandedStatistics.add(m_nodesExpanded);
+    m_nodesVisitedStatistics.add(m_nodesVisited);
+    m_pathLengthStatistics.add(m_path.size());
+    return ! m_isAborted;
+}
+
+void ARAStar::findPathAra(int start)
+{
+    m_nodeStates.init(m_numberNodes);
+    m_closedInRound.init(m_numberNodes);
+    m_isInconsistent.init(m_numberNodes);
+    m_inconsistent.clear();
+    m_open.init();
+    m_bound = getRoundBound(0);
+    m_nodeStates.setOpen(start, 0, NO_NODE);
+    m_open.insert(start, 0, getWeightedHeuristic(start));
+    m_openSize = 1;
+    m_maxOpenSize = 0;
+    int round;
+    for (round = 0; round < m_numberRounds; ++round)
+    {
+        if (round > 0)
+        {
+            m_bound = getRoundBound(round);
+            rebuildOpen();
+        }
+        long long int nodesExpanded = m_nodesExpanded;
+        if (! improvePath())
+        {
+            m_isAborted = true;
+            break;
+        }
+        if (m_nodeStates.getState(m_target) == NodeStateArray::UNSEEN)
+            break; // no path
+        m_path = m_nodeStates.constructPath(start, m_target);
+        m_pathCost = m_nodeStates.getG(m_target);
+        m_pathBound = m_bound;
+        RoundStatistics& roundStatistics = m_roundStatistics[round];
+        roundStatistics.m_bound->add(m_bound);
+        roundStatistics.m_nodesExpanded->add(m_nodesExpanded
+                                             - nodesExpanded);
+        roundStatistics.m_pathCost->add(m_pathCost);
+    }
+    m_roundsStatistics.add(round);
+    if (m_pathCost >= 0)
+        m_pathCostStatistics.add(m_pathCost);
+    if (SAMPLE_EXPANSIONS)
+        m_openMaxStatistics.add(m_maxOpenSize);
+}
+
+double ARAStar::getRoundBound(int round) const
+{
+    assert(round >= 0 && round < m_numberRounds);
+    return computeRoundBound(m_initialBound, m_boundStep, round);
+}
+
+const StatisticsCollection& ARAStar::getStatistics() const
+{
+    return m_statistics;
+}
+
+const vector<char>& ARAStar::getVisitedNodes() const
+{
+    return getVisitedNodeLabels(m_numberNodes);
+}
+
+bool ARAStar::improvePath()
+{
+    while (! m_open.isEmpty())
+    {
+        int nodeId;
+        int g;
+        int f;
+        m_open.top(nodeId, g, f);
+        if (! isOpenEntry(m_nodeStates, nodeId, g))
+        {
+            m_open.pop(nodeId, g, f); // outdated entry
+            continue;
+        }
+        // The heuristic of the target is 0, so its f value is its g value
+        if (m_nodeStates.getState(m_target) != NodeStateArray::UNSEEN
+            && m_nodeStates.getG(m_target) <= f)
+            return true;
+        if (SAMPLE_EXPANSIONS)
+        {
+            m_openLengthStatistics.add(m_openSize);
+            if (m_openSize > m_maxOpenSize)
+                m_maxOpenSize = m_openSize;
+        }
+        m_open.pop(nodeId, g, f);
+        m_nodeStates.setClosed(nodeId);
+        m_closedInRound.mark(nodeId);
+        --m_openSize;
+        ++m_nodesVisited;
+        traceVisited(nodeId);
+        if (m_nodesLimit >= 0 && m_nodesVisited > m_nodesLimit)
+            return false;
+        ++m_nodesExpanded;
+        Relaxer relaxer(*this, nodeId, g);
+        m_env->visitSuccessors(nodeId, NO_NODE, relaxer);
+        if (SAMPLE_EXPANSIONS)
+            m_branchingFactor.add(relaxer.getNumberSuccessors());
+    }
+    return true;
+}
+
+void ARAStar::rebuildOpen()
+{
+    m_reopen.clear();
+    while (! m_open.isEmpty())
+    {
+        int nodeId;
+        int g;
+        int f;
+        m_open.pop(nodeId, g, f);
+        if (isOpenEntry(m_nodeStates, nodeId, g))
+            m_reopen.push_back(nodeId);
+    }
+    for (vector<int>::const_iterator i = m_inconsistent.begin();
+         i != m_inconsistent.end(); ++i)
+    {
+        m_nodeStates.setOpen(*i, m_nodeStates.getG(*i),
+                             m_nodeStates.getParent(*i));
+        ++m_openSize;
+        m_reopen.push_back(*i);
+    }
+    m_inconsistent.clear();
+    m_isInconsistent.clear();
+    m_closedInRound.clear();
+    m_open.init();
+    for (vector<int>::const_iterator i = m_reopen.begin();
+         i != m_reopen.end(); ++i)
+    {
+        int g = m_nodeStates.getG(*i);
+        m_open.insert(*i, g, g + getWeightedHeuristic(*i));
+    }
+}
+
+void ARAStar::relax(int nodeId, int g, int target, int cost)
+{
+    int newg = g + cost;
+    NodeStateArray::State state = m_nodeStates.getState(target);
+    if (state != NodeStateArray::UNSEEN
+        && newg >= m_nodeStates.getG(target))
+        return;
+    if (state == NodeStateArray::CLOSED && m_closedInRound.isMarked(target))
+    {
+        // Not expanded again in this round
+        m_nodeStates.setOpen(target, newg, nodeId);
+        m_nodeStates.setClosed(target);
+        if (! m_isInconsistent.isMarked(target))
+        {
+            m_isInconsistent.mark(target);
+            m_inconsistent.push_back(target);
+        }
+        return;
+    }
+    m_nodeStates.setOpen(target, newg, nodeId);
+    if (state != NodeStateArray::OPEN)
+        ++m_openSize;
+    m_open.insert(target, newg, newg + getWeightedHeuristic(target));
+}
+
+//-----------------------------------------------------------------------------
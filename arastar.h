@@ -0,0 +1,244 @@
+//-----------------------------------------------------------------------------
+/** @file arastar.h
+    Anytime Repairing A* (ARA*).
+
+    Short description of ARA*:
+
+    A series of weighted A* searches with f = g + bound * h and a bound
+    that decreases from round to round until it reaches 1. Each round
+    finds a path that costs at most the bound times the optimal path
+    cost. Instead of starting again, a round keeps the g values and
+    parents of the previous round. Nodes whose g value decreased after
+    they were expanded in a round are not reopened in that round, but
+    collected in a list of inconsistent nodes, and added to the open
+    list at the start of the next round. A round ends as soon as the
+    target has the lowest f value, so later rounds only repair the
+    part of the search tree that changes with the smaller bound.
+
+    See M. Likhachev, G. Gordon, S. Thrun: ARA*: Anytime A* with Provable
+    Bounds on Sub-Optimality (NIPS 2003).
+*/
+//-----------------------------------------------------------------------------
+
+#ifndef PATHFIND_ARASTAR_H
+#define PATHFIND_ARASTAR_H
+
+#include "basicastar.h"
+#include "markerarray.h"
+#include "nodestatearray.h"
+#include "search.h"
+
+//-----------------------------------------------------------------------------
+
+namespace PathFind
+{
+    using namespace std;
+
+    /** Anytime Repairing A* search engine.
+        The nodes limit is the budget of all rounds of a search. If it is
+        reached, the search returns the path of the last completed round.
+        Collects the same statistics as AStar for the whole search, and
+        a trace of the rounds: the number of completed rounds (rounds),
+        and for each round i, starting with 1, the suboptimality bound
+        (roundi_bound), the path cost (roundi_path_cost) and the number
+        of nodes expanded in the round (roundi_nodes_expanded), with i
+        printed with two digits. Rounds that were not completed are not
+        sampled.
+    */
+    class ARAStar
+        : public Search
+    {
+    public:
+        /** Constructor.
+            @param initialBound Suboptimality bound of the first round.
+            @param boundStep Decrease of the bound after each round.
+            @throws Error, if initialBound is smaller than 1 or boundStep
+            is not positive.
+        */
+        explicit ARAStar(double initialBound = 2.5, double boundStep = 0.5);
+
+        StatisticsCollection createStatistics();
+
+        /** Find a path.
+            @return false, if the search was aborted due to the node limit
+            before the round with bound 1 was completed. getPath() returns
+            the path of the last completed round in this case, or an
+            empty path if no round was completed.
+        */
+        bool findPath(const Environment& env, int start, int target);
+
+        /** Suboptimality bound of the path found.
+            The bound of the last completed round, 0 if no round was
+            completed.
+        */
+        double getBound() const
+        {
+            return m_pathBound;
+        }
+
+        int getNumberRounds() const
+        {
+            return m_numberRounds;
+        }
+
+        const vector<int>& getPath() const
+        {
+            return m_path;
+        }
+
+        int getPathCost() const
+        {
+            return m_pathCost;
+        }
+
+        /** Suboptimality bound used in a round.
+            @param round Index of the round, starting with 0.
+        */
+        double getRoundBound(int round) const;
+
+        const StatisticsCollection& getStatistics() const;
+
+        /** Get a vector with '+' char labels for each visited node.
+            @see Search::getVisitedNodes
+        */
+        const vector<char>& getVisitedNodes() const;
+
+    private:
+        class Relaxer;
+
+        friend class Relaxer;
+
+        /** Visitor that relaxes the successors of an expanded node. */
+        class Relaxer
+            : public Environment::SuccessorVisitor
+        {
+        public:
+            Relaxer(ARAStar& search, int nodeId, int g);
+
+            int getNumberSuccessors() const
+            {
+                return m_numberSuccessors;
+            }
+
+            bool visit(int target, int cost);
+
+        private:
+            ARAStar& m_search;
+
+            int m_nodeId;
+
+            int m_g;
+
+            int m_numberSuccessors;
+        };
+
+        /** Statistics of one round. */
+        class RoundStatistics
+        {
+        public:
+            Statistics* m_bound;
+
+            Statistics* m_nodesExpanded;
+
+            Statistics* m_pathCost;
+        };
+
+        bool m_isAborted;
+
+        double m_initialBound;
+
+        double m_boundStep;
+
+        int m_numberRounds;
+
+        /** Bound of the current round while searching. */
+        double m_bound;
+
+        double m_pathBound;
+
+        int m_pathCost;
+
+        int m_target;
+
+        const Environment* m_env;
+
+        long long int m_nodesExpanded;
+
+        long long int m_nodesVisited;
+
+        /** Number of nodes of the environment in the last search. */
+        int m_numberNodes;
+
+        /** Number of nodes in state OPEN. */
+        int m_openSize;
+
+        /** Largest number of nodes in state OPEN in the current search. */
+        int m_maxOpenSize;
+
+        /** Nodes with a g value. Closed nodes were expanded in a round,
+            not necessarily in the current one.
+        */
+        NodeStateArray m_nodeStates;
+
+        /** Nodes expanded in the current round. */
+        MarkerArray m_closedInRound;
+
+        /** Nodes in m_inconsistent. */
+        MarkerArray m_isInconsistent;
+
+        /** Nodes expanded in the current round whose g value decreased
+            afterwards.
+        */
+        vector<int> m_inconsistent;
+
+        BasicOpenHeap m_open;
+
+        /** Work space for rebuilding the open list. */
+        vector<int> m_reopen;
+
+        vector<int> m_path;
+
+        StatisticsCollection m_statistics;
+
+        Statistics& m_branchingFactor;
+
+        Statistics& m_cpuTimeStatistics;
+
+        Statistics& m_nodesExpandedStatistics;
+
+        Statistics& m_nodesVisitedStatistics;
+
+        Statistics& m_openLengthStatistics;
+
+        Statistics& m_openMaxStatistics;
+
+        Statistics& m_pathCostStatistics;
+
+        Statistics& m_pathLengthStatistics;
+
+        Statistics& m_roundsStatistics;
+
+        vector<RoundStatistics> m_roundStatistics;
+
+        void findPathAra(int start);
+
+        /** Heuristic to the target multiplied by the current bound. */
+        int getWeightedHeuristic(int nodeId) const;
+
+        /** Run weighted A* until the target has the lowest f value.
+            @return false, if the search was aborted due to node limit.
+        */
+        bool improvePath();
+
+        /** Move the inconsistent nodes to the open list and compute the
+            f values of all open nodes with the current bound.
+        */
+        void rebuildOpen();
+
+        void relax(int nodeId, int g, int target, int cost);
+    };
+}
+
+//-----------------------------------------------------------------------------
+
+#endif
@@ -9,10 +9,13 @@
 
 #include "astar.h"
 
+#include <algorithm>
 #include <iostream>
+#include <limits.h>
 #include <math.h>
 #include <memory>
 #include <assert.h>
+#include "error.h"
 #include "util.h"
 
 using namespace std;
@@ -22,13 +25,50 @@ using namespace PathFind;
 
 static const int NO_COST = -1;
 
+//-----------------------------------------------------------------------------
+
+namespace
+{
+    /** Visitor that finds the cost of the edge to a node. */
+    class EdgeCostFinder
+        : public Environment::SuccessorVisitor
+    {
+    public:
+        explicit EdgeCostFinder(int target)
+            : m_target(target),
+              m_cost(NO_COST)
+        {
+        }
+
+        /** Get the lowest cost of an edge to the target.
+            @return NO_COST, if the target is not a successor.
+        */
+        int getCost() const
+        {
+            return m_cost;
+        }
+
+        bool visit(int target, int cost)
+        {
+            if (target == m_target && (m_cost == NO_COST || cost < m_cost))
+                m_cost = cost;
+            return true;
+        }
+
+    private:
+        int m_target;
+
+        int m_cost;
+    };
+}
+
 AStar::AStarNode::Compare::~Compare()
 {
     ;
 }
 
 bool AStar::AStarNode::Compare::operator()(const AStarNode& node1,
-                                           const AStarNode& node2)
+                                           const AStarNode& node2) const
 {
     int f1 = node1.m_f;
     int f2 = node2.m_f;
@@ -130,8 +170,8 @@ void AStar::ClosedListPerfectHash::add(const AStarNode& node)
     int nodeId = node.m_nodeId;
     assert(nodeId >= 0);
     assert(nodeId < m_maxNodeId);
-    assert(m_marker[nodeId] == false);
-    m_marker[nodeId] = true;
+    assert(! m_marker.isMarked(nodeId));
+    m_marker.mark(nodeId);
     m_nodes[nodeId] = node;
 }
 
@@ -139,8 +179,7 @@ void AStar::ClosedListPerfectHash::init(int maxNodeId)
 {
     assert(maxNodeId >= 0);
     m_nodes.resize(maxNodeId);
-    m_marker.clear();
-    m_marker.resize(maxNodeId, false);
+    m_marker.init(maxNodeId);
     m_maxNodeId = maxNodeId;
 }
 
@@ -148,15 +187,15 @@ void AStar::ClosedListPerfectHash::remove(int nodeId)
 {
     assert(nodeId >= 0);
     assert(nodeId < m_maxNodeId);
-    assert(m_marker[nodeId] == true);
-    m_marker[nodeId] = false;
+    assert(m_marker.isMarked(nodeId));
+    m_marker.unmark(nodeId);
 }
 
 const AStar::AStarNode* AStar::ClosedListPerfectHash::search(int nodeId) const
 {
     assert(nodeId >= 0);
     assert(nodeId < m_maxNodeId);
-    if (! m_marker[nodeId])
+    if (! m_marker.isMarked(nodeId))
         return 0;
     const AStarNode* result = &m_nodes[nodeId];
     return result;
@@ -164,15 +203,129 @@ const AStar::AStarNode* AStar::ClosedListPerfectHash::search(int nodeId) const
 
 //-----------------------------------------------------------------------------
 
+AStar::NodeHashTable::NodeHashTable()
+    : m_base(1),
+      m_numberUsed(0),
+      m_shift(32 - MIN_SLOTS_LOG2)
+{
+    Slot empty;
+    empty.m_state = 0;
+    m_slots.assign(1 << MIN_SLOTS_LOG2, empty);
+}
+
+vector<int> AStar::NodeHashTable::constructPath(int start, int target) const
+{
+    vector<int> result;
+    int nodeId = target;
+    while (true)
+    {
+        result.push_back(nodeId);
+        if (nodeId == start)
+            break;
+        int slot = find(nodeId);
+        assert(slot >= 0);
+        nodeId = m_slots[slot].m_parent;
+    }
+    assert(*(result.end() - 1) == start);
+    return result;
+}
+
+int AStar::NodeHashTable::find(int nodeId) const
+{
+    int mask = getNumberSlots() - 1;
+    for (int slot = getStartSlot(nodeId); isUsed(slot);
+         slot = (slot + 1) & mask)
+        if (m_slots[slot].m_nodeId == nodeId)
+            return slot;
+    return -1;
+}
+
+void AStar::NodeHashTable::grow()
+{
+    vector<Slot> oldSlots;
+    oldSlots.swap(m_slots);
+    unsigned int oldBase = m_base;
+    Slot empty;
+    empty.m_state = 0;
+    m_slots.assign(2 * oldSlots.size(), empty);
+    --m_shift;
+    m_base = 1;
+    int mask = getNumberSlots() - 1;
+    for (vector<Slot>::const_iterator i = oldSlots.begin();
+         i != oldSlots.end(); ++i)
+    {
+        if (i->m_state < oldBase)
+            continue;
+        int slot = getStartSlot(i->m_nodeId);
+        while (isUsed(slot))
+            slot = (slot + 1) & mask;
+        m_slots[slot] = *i;
+        m_slots[slot].m_state = m_base + (i->m_state - oldBase);
+    }
+}
+
+void AStar::NodeHashTable::init()
+{
+    m_numberUsed = 0;
+    m_base += (NodeStateArray::CLOSED + 1);
+    if (m_base > UINT_MAX - NodeStateArray::CLOSED)
+    {
+        for (vector<Slot>::iterator i = m_slots.begin();
+             i != m_slots.end(); ++i)
+            i->m_state = 0;
+        m_base = 1;
+    }
+}
+
+int AStar::NodeHashTable::lookup(int nodeId)
+{
+    assert(nodeId >= 0);
+    int mask = getNumberSlots() - 1;
+    int slot = getStartSlot(nodeId);
+    for ( ; isUsed(slot); slot = (slot + 1) & mask)
+        if (m_slots[slot].m_nodeId == nodeId)
+            return slot;
+    // Keep load factor at most 1/2
+    if (2 * (m_numberUsed + 1) > getNumberSlots())
+    {
+        grow();
+        mask = getNumberSlots() - 1;
+        slot = getStartSlot(nodeId);
+        while (isUsed(slot))
+            slot = (slot + 1) & mask;
+    }
+    ++m_numberUsed;
+    Slot& entry = m_slots[slot];
+    entry.m_nodeId = nodeId;
+    entry.m_state = m_base + NodeStateArray::UNSEEN;
+    return slot;
+}
+
+//-----------------------------------------------------------------------------
+
+AStar::OpenListBase::~OpenListBase()
+{
+    ;
+}
+
+//-----------------------------------------------------------------------------
+
 AStar::OpenQueue::OpenQueue()
 {
-    init(0);
+    init(0, 0);
 }
 
-void AStar::OpenQueue::init(int numberNodes)
+bool AStar::OpenQueue::decreaseKey(const AStarNode& node)
 {
-    m_marker.clear();
-    m_marker.resize(numberNodes, false);
+    if (! remove(node.m_nodeId))
+        return false;
+    insert(node);
+    return true;
+}
+
+void AStar::OpenQueue::init(int numberNodes, int maxCost)
+{
+    m_marker.init(numberNodes);
     m_lookupTable.resize(numberNodes);
     m_numberNodes = numberNodes;
     m_nodes.clear();
@@ -182,8 +335,8 @@ void AStar::OpenQueue::insert(const AStarNode& node)
 {
     int nodeId = node.m_nodeId;
     assert(nodeId < m_numberNodes);
-    assert(m_marker[nodeId] == false);
-    m_marker[nodeId] = true;
+    assert(! m_marker.isMarked(nodeId));
+    m_marker.mark(nodeId);
     NodeSetIterator pos = m_nodes.insert(node);
     m_lookupTable[nodeId] = pos;
 }
@@ -195,8 +348,8 @@ AStar::AStarNode AStar::OpenQueue::pop()
     m_nodes.erase(m_nodes.begin());
     int nodeId = result.m_nodeId;
     assert(nodeId < m_numberNodes);
-    assert(m_marker[nodeId] == true);
-    m_marker[nodeId] = false;
+    assert(m_marker.isMarked(nodeId));
+    m_marker.unmark(nodeId);
     return result;
 }
 
@@ -215,11 +368,11 @@ bool AStar::OpenQueue::remove(int nodeId)
 {
     assert(nodeId >= 0);
     assert(nodeId < m_numberNodes);
-    if (! m_marker[nodeId])
+    if (! m_marker.isMarked(nodeId))
         return false;
     NodeSetIterator pos = m_lookupTable[nodeId];
     m_nodes.erase(pos);
-    m_marker[nodeId] = false;
+    m_marker.unmark(nodeId);
     return true;
 }
 
@@ -227,49 +380,638 @@ const AStar::AStarNode* AStar::OpenQueue::search(int nodeId) const
 {
     assert(nodeId >= 0);
     assert(nodeId < m_numberNodes);
-    if (m_marker[nodeId])
+    if (m_marker.isMarked(nodeId))
         return &(*m_lookupTable[nodeId]);
     return 0;
 }
 
 //-----------------------------------------------------------------------------
 
-AStar::AStar(bool usePerfectHashClosedList)
-    : m_statistics(createStatistics()),
-      m_branchingFactor(m_statistics.get("branching_factor"))
+AStar::OpenIndexedBase::OpenIndexedBase()
+    : m_numberNodes(0),
+      m_nextSequence(0)
 {
-    if (usePerfectHashClosedList)
-        m_closed.reset(new ClosedListPerfectHash());
+}
+
+bool AStar::OpenIndexedBase::isBetter(int nodeId1, int nodeId2) const
+{
+    const AStarNode& node1 = m_nodes[nodeId1];
+    const AStarNode& node2 = m_nodes[nodeId2];
+    if (node1.m_f != node2.m_f)
+        return (node1.m_f < node2.m_f);
+    if (node1.m_g != node2.m_g)
+        return (node1.m_g > node2.m_g);
+    return (m_sequence[nodeId1] < m_sequence[nodeId2]);
+}
+
+const AStar::AStarNode* AStar::OpenIndexedBase::search(int nodeId) const
+{
+    assert(nodeId >= 0);
+    assert(nodeId < m_numberNodes);
+    if (m_marker.isMarked(nodeId))
+        return &m_nodes[nodeId];
+    return 0;
+}
+
+void AStar::OpenIndexedBase::setNode(const AStarNode& node)
+{
+    int nodeId = node.m_nodeId;
+    m_nodes[nodeId] = node;
+    m_sequence[nodeId] = m_nextSequence++;
+}
+
+//-----------------------------------------------------------------------------
+
+bool AStar::OpenBinaryHeap::decreaseKey(const AStarNode& node)
+{
+    int nodeId = node.m_nodeId;
+    assert(nodeId >= 0);
+    assert(nodeId < m_numberNodes);
+    if (! m_marker.isMarked(nodeId))
+        return false;
+    assert(node.m_f <= m_nodes[nodeId].m_f);
+    setNode(node);
+    moveUp(m_position[nodeId]);
+    return true;
+}
+
+void AStar::OpenBinaryHeap::init(int numberNodes, int maxCost)
+{
+    m_heap.clear();
+    m_marker.init(numberNodes);
+    if (numberNodes != m_numberNodes)
+    {
+        m_nodes.resize(numberNodes);
+        m_sequence.resize(numberNodes);
+        m_position.resize(numberNodes);
+        m_numberNodes = numberNodes;
+    }
+    m_nextSequence = 0;
+}
+
+void AStar::OpenBinaryHeap::insert(const AStarNode& node)
+{
+    int nodeId = node.m_nodeId;
+    assert(nodeId >= 0);
+    assert(nodeId < m_numberNodes);
+    assert(! m_marker.isMarked(nodeId));
+    m_marker.mark(nodeId);
+    setNode(node);
+    m_heap.push_back(nodeId);
+    moveUp(m_heap.size() - 1);
+}
+
+void AStar::OpenBinaryHeap::moveDown(int position)
+{
+    int size = m_heap.size();
+    int nodeId = m_heap[position];
+    while (true)
+    {
+        int child = 2 * position + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && isBetter(m_heap[child + 1], m_heap[child]))
+            ++child;
+        if (! isBetter(m_heap[child], nodeId))
+            break;
+        place(m_heap[child], position);
+        position = child;
+    }
+    place(nodeId, position);
+}
+
+void AStar::OpenBinaryHeap::moveUp(int position)
+{
+    int nodeId = m_heap[position];
+    while (position > 0)
+    {
+        int parent = (position - 1) / 2;
+        if (! isBetter(nodeId, m_heap[parent]))
+            break;
+        place(m_heap[parent], position);
+        position = parent;
+    }
+    place(nodeId, position);
+}
+
+AStar::AStarNode AStar::OpenBinaryHeap::pop()
+{
+    assert(! isEmpty());
+    int nodeId = m_heap[0];
+    assert(m_marker.isMarked(nodeId));
+    m_marker.unmark(nodeId);
+    int last = m_heap.back();
+    m_heap.pop_back();
+    if (! m_heap.empty())
+    {
+        place(last, 0);
+        moveDown(0);
+    }
+    return m_nodes[nodeId];
+}
+
+void AStar::OpenBinaryHeap::print(ostream& ostrm) const
+{
+   ostrm << "Open {\n";
+   for (vector<int>::const_iterator i = m_heap.begin();
+        i != m_heap.end(); ++i)
+   {
+       m_nodes[*i].print(ostrm);
+       ostrm << '\n';
+   }
+   ostrm << "}\n";
+}
+
+bool AStar::OpenBinaryHeap::remove(int nodeId)
+{
+    assert(nodeId >= 0);
+    assert(nodeId < m_numberNodes);
+    if (! m_marker.isMarked(nodeId))
+        return false;
+    m_marker.unmark(nodeId);
+    int position = m_position[nodeId];
+    int last = m_heap.back();
+    m_heap.pop_back();
+    if (last != nodeId)
+    {
+        place(last, position);
+        moveUp(position);
+        moveDown(m_position[last]);
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+AStar::OpenPairingHeap::OpenPairingHeap()
+    : m_root(NO_NODE),
+      m_size(0)
+{
+}
+
+int AStar::OpenPairingHeap::combineSiblings(int nodeId)
+{
+    m_subtrees.clear();
+    while (nodeId != NO_NODE)
+    {
+        int next = m_next[nodeId];
+        m_next[nodeId] = NO_NODE;
+        m_previous[nodeId] = NO_NODE;
+        m_subtrees.push_back(nodeId);
+        nodeId = next;
+    }
+    int size = m_subtrees.size();
+    if (size == 0)
+        return NO_NODE;
+    // First pass: meld pairs from left to right
+    int numberPairs = 0;
+    for (int i = 0; i + 1 < size; i += 2)
+        m_subtrees[numberPairs++] = meld(m_subtrees[i], m_subtrees[i + 1]);
+    if (size % 2 != 0)
+        m_subtrees[numberPairs++] = m_subtrees[size - 1];
+    // Second pass: meld results from right to left
+    int result = m_subtrees[numberPairs - 1];
+    for (int i = numberPairs - 2; i >= 0; --i)
+        result = meld(m_subtrees[i], result);
+    return result;
+}
+
+void AStar::OpenPairingHeap::cut(int nodeId)
+{
+    assert(nodeId != m_root);
+    int previous = m_previous[nodeId];
+    int next = m_next[nodeId];
+    assert(previous != NO_NODE);
+    if (m_child[previous] == nodeId)
+        m_child[previous] = next;
     else
-        m_closed.reset(new ClosedList());
+        m_next[previous] = next;
+    if (next != NO_NODE)
+        m_previous[next] = previous;
+    m_next[nodeId] = NO_NODE;
+    m_previous[nodeId] = NO_NODE;
+}
+
+bool AStar::OpenPairingHeap::decreaseKey(const AStarNode& node)
+{
+    int nodeId = node.m_nodeId;
+    assert(nodeId >= 0);
+    assert(nodeId < m_numberNodes);
+    if (! m_marker.isMarked(nodeId))
+        return false;
+    assert(node.m_f <= m_nodes[nodeId].m_f);
+    setNode(node);
+    if (nodeId != m_root)
+    {
+        cut(nodeId);
+        m_root = meld(m_root, nodeId);
+    }
+    return true;
+}
+
+void AStar::OpenPairingHeap::init(int numberNodes, int maxCost)
+{
+    m_root = NO_NODE;
+    m_size = 0;
+    m_marker.init(numberNodes);
+    if (numberNodes != m_numberNodes)
+    {
+        m_nodes.resize(numberNodes);
+        m_sequence.resize(numberNodes);
+        m_child.resize(numberNodes);
+        m_next.resize(numberNodes);
+        m_previous.resize(numberNodes);
+        m_numberNodes = numberNodes;
+    }
+    m_nextSequence = 0;
+}
+
+void AStar::OpenPairingHeap::insert(const AStarNode& node)
+{
+    int nodeId = node.m_nodeId;
+    assert(nodeId >= 0);
+    assert(nodeId < m_numberNodes);
+    assert(! m_marker.isMarked(nodeId));
+    m_marker.mark(nodeId);
+    setNode(node);
+    m_child[nodeId] = NO_NODE;
+    m_next[nodeId] = NO_NODE;
+    m_previous[nodeId] = NO_NODE;
+    m_root = meld(m_root, nodeId);
+    ++m_size;
+}
+
+int AStar::OpenPairingHeap::meld(int nodeId1, int nodeId2)
+{
+    if (nodeId1 == NO_NODE)
+        return nodeId2;
+    if (nodeId2 == NO_NODE)
+        return nodeId1;
+    if (isBetter(nodeId2, nodeId1))
+        swap(nodeId1, nodeId2);
+    // Make nodeId2 the first child of nodeId1
+    int child = m_child[nodeId1];
+    m_next[nodeId2] = child;
+    if (child != NO_NODE)
+        m_previous[child] = nodeId2;
+    m_previous[nodeId2] = nodeId1;
+    m_child[nodeId1] = nodeId2;
+    return nodeId1;
+}
+
+AStar::AStarNode AStar::OpenPairingHeap::pop()
+{
+    assert(! isEmpty());
+    int nodeId = m_root;
+    assert(m_marker.isMarked(nodeId));
+    m_marker.unmark(nodeId);
+    m_root = combineSiblings(m_child[nodeId]);
+    m_child[nodeId] = NO_NODE;
+    --m_size;
+    return m_nodes[nodeId];
+}
+
+void AStar::OpenPairingHeap::print(ostream& ostrm) const
+{
+   ostrm << "Open {\n";
+   for (int nodeId = 0; nodeId < m_numberNodes; ++nodeId)
+       if (m_marker.isMarked(nodeId))
+       {
+           m_nodes[nodeId].print(ostrm);
+           ostrm << '\n';
+       }
+   ostrm << "}\n";
+}
+
+bool AStar::OpenPairingHeap::remove(int nodeId)
+{
+    assert(nodeId >= 0);
+    assert(nodeId < m_numberNodes);
+    if (! m_marker.isMarked(nodeId))
+        return false;
+    m_marker.unmark(nodeId);
+    if (nodeId != m_root)
+        cut(nodeId);
+    int subtree = combineSiblings(m_child[nodeId]);
+    m_child[nodeId] = NO_NODE;
+    if (nodeId == m_root)
+        m_root = subtree;
+    else
+        m_root = meld(m_root, subtree);
+    --m_size;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+AStar::OpenBucketQueue::OpenBucketQueue()
+    : m_useHeap(false),
+      m_minF(0),
+      m_size(0)
+{
+}
+
+bool AStar::OpenBucketQueue::decreaseKey(const AStarNode& node)
+{
+    if (m_useHeap)
+        return m_heap.decreaseKey(node);
+    int nodeId = node.m_nodeId;
+    assert(nodeId >= 0);
+    assert(nodeId < m_numberNodes);
+    if (! m_marker.isMarked(nodeId))
+        return false;
+    assert(node.m_f <= m_nodes[nodeId].m_f);
+    unlink(nodeId);
+    setNode(node);
+    link(nodeId);
+    return true;
+}
+
+void AStar::OpenBucketQueue::init(int numberNodes, int maxCost)
+{
+    int numberBuckets = 2 * maxCost + 1;
+    m_useHeap = (maxCost < 0 || numberBuckets > MAX_BUCKETS);
+    if (m_useHeap)
+    {
+        m_heap.init(numberNodes, maxCost);
+        return;
+    }
+    m_buckets.assign(numberBuckets, NO_NODE);
+    m_marker.init(numberNodes);
+    if (numberNodes != m_numberNodes)
+    {
+        m_nodes.resize(numberNodes);
+        m_sequence.resize(numberNodes);
+        m_next.resize(numberNodes);
+        m_previous.resize(numberNodes);
+        m_numberNodes = numberNodes;
+    }
+    m_minF = 0;
+    m_size = 0;
+    m_nextSequence = 0;
+}
+
+void AStar::OpenBucketQueue::insert(const AStarNode& node)
+{
+    if (m_useHeap)
+    {
+        m_heap.insert(node);
+        return;
+    }
+    int nodeId = node.m_nodeId;
+    assert(nodeId >= 0);
+    assert(nodeId < m_numberNodes);
+    assert(! m_marker.isMarked(nodeId));
+    m_marker.mark(nodeId);
+    setNode(node);
+    link(nodeId);
+    ++m_size;
+}
+
+void AStar::OpenBucketQueue::link(int nodeId)
+{
+    int f = m_nodes[nodeId].m_f;
+    assert(f >= 0);
+    if (m_size == 0 || f < m_minF)
+        m_minF = f;
+    assert(f - m_minF < static_cast<int>(m_buckets.size()));
+    int& first = m_buckets[getBucket(f)];
+    m_previous[nodeId] = NO_NODE;
+    m_next[nodeId] = first;
+    if (first != NO_NODE)
+        m_previous[first] = nodeId;
+    first = nodeId;
+}
+
+AStar::AStarNode AStar::OpenBucketQueue::pop()
+{
+    if (m_useHeap)
+        return m_heap.pop();
+    assert(! isEmpty());
+    while (m_buckets[getBucket(m_minF)] == NO_NODE)
+        ++m_minF;
+    int nodeId = m_buckets[getBucket(m_minF)];
+    assert(m_nodes[nodeId].m_f == m_minF);
+    assert(m_marker.isMarked(nodeId));
+    m_marker.unmark(nodeId);
+    unlink(nodeId);
+    --m_size;
+    return m_nodes[nodeId];
+}
+
+void AStar::OpenBucketQueue::print(ostream& ostrm) const
+{
+    if (m_useHeap)
+    {
+        m_heap.print(ostrm);
+        return;
+    }
+    ostrm << "Open {\n";
+    for (int nodeId = 0; nodeId < m_numberNodes; ++nodeId)
+        if (m_marker.isMarked(nodeId))
+        {
+            m_nodes[nodeId].print(ostrm);
+            ostrm << '\n';
+        }
+    ostrm << "}\n";
+}
+
+bool AStar::OpenBucketQueue::remove(int nodeId)
+{
+    if (m_useHeap)
+        return m_heap.remove(nodeId);
+    assert(nodeId >= 0);
+    assert(nodeId < m_numberNodes);
+    if (! m_marker.isMarked(nodeId))
+        return false;
+    m_marker.unmark(nodeId);
+    unlink(nodeId);
+    --m_size;
+    return true;
+}
+
+const AStar::AStarNode* AStar::OpenBucketQueue::search(int nodeId) const
+{
+    if (m_useHeap)
+        return m_heap.search(nodeId);
+    return OpenIndexedBase::search(nodeId);
+}
+
+void AStar::OpenBucketQueue::unlink(int nodeId)
+{
+    int previous = m_previous[nodeId];
+    int next = m_next[nodeId];
+    if (previous != NO_NODE)
+        m_next[previous] = next;
+    else
+        m_buckets[getBucket(m_nodes[nodeId].m_f)] = next;
+    if (next != NO_NODE)
+        m_previous[next] = previous;
+}
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+    /** Check if an entry of a lazy open list is not outdated. */
+    bool isOpenEntry(const NodeStateArray& nodeStates, int nodeId, int g)
+    {
+        return (nodeStates.getState(nodeId) == NodeStateArray::OPEN
+                && nodeStates.getG(nodeId) == g);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+AStar::AStar(bool usePerfectHashClosedList, OpenListType openListType)
+    : m_closedListType(usePerfectHashClosedList ? CLOSED_PERFECT_HASH
+                       : CLOSED_LIST),
+      m_isAborted(false),
+      m_isSearching(false),
+      m_useFocal(false),
+      m_suboptimalMode(SUBOPTIMAL_WEIGHTED),
+      m_suboptimalityBound(1),
+      m_heuristicWeight(1),
+      m_pathCost(NO_COST),
+      m_start(NO_NODE),
+      m_target(NO_NODE),
+      m_maxOpen(0),
+      m_cpuTime(0),
+      m_env(0),
+      m_nodesExpanded(0),
+      m_nodesVisited(0),
+      m_useSparseHash(false),
+      m_numberNodes(0),
+      m_expandedNodeId(NO_NODE),
+      m_expandedG(0),
+      m_openSize(0),
+      m_focalBound(0),
+      m_statistics(createStatistics()),
+      m_branchingFactor(m_statistics.get("branching_factor")),
+      m_cpuTimeStatistics(m_statistics.get("cpu_time")),
+      m_nodesExpandedStatistics(m_statistics.get("nodes_expanded")),
+      m_nodesVisitedStatistics(m_statistics.get("nodes_visited")),
+      m_openLengthStatistics(m_statistics.get("open_length")),
+      m_openMaxStatistics(m_statistics.get("open_max")),
+      m_pathCostStatistics(m_statistics.get("path_cost")),
+      m_pathLengthStatistics(m_statistics.get("path_length"))
+{
+    createLists(openListType);
+}
+
+AStar::AStar(ClosedListType closedListType, OpenListType openListType)
+    : m_closedListType(closedListType),
+      m_isAborted(false),
+      m_isSearching(false),
+      m_useFocal(false),
+      m_suboptimalMode(SUBOPTIMAL_WEIGHTED),
+      m_suboptimalityBound(1),
+      m_heuristicWeight(1),
+      m_pathCost(NO_COST),
+      m_start(NO_NODE),
+      m_target(NO_NODE),
+      m_maxOpen(0),
+      m_cpuTime(0),
+      m_env(0),
+      m_nodesExpanded(0),
+      m_nodesVisited(0),
+      m_useSparseHash(false),
+      m_numberNodes(0),
+      m_expandedNodeId(NO_NODE),
+      m_expandedG(0),
+      m_openSize(0),
+      m_focalBound(0),
+      m_statistics(createStatistics()),
+      m_branchingFactor(m_statistics.get("branching_factor")),
+      m_cpuTimeStatistics(m_statistics.get("cpu_time")),
+      m_nodesExpandedStatistics(m_statistics.get("nodes_expanded")),
+      m_nodesVisitedStatistics(m_statistics.get("nodes_visited")),
+      m_openLengthStatistics(m_statistics.get("open_length")),
+      m_openMaxStatistics(m_statistics.get("open_max")),
+      m_pathCostStatistics(m_statistics.get("path_cost")),
+      m_pathLengthStatistics(m_statistics.get("path_length"))
+{
+    createLists(openListType);
+}
+
+inline int AStar::getHeuristic(int nodeId) const
+{
+    int heuristic = m_env->getHeuristic(nodeId, m_target);
+    if (m_heuristicWeight == 1)
+        return heuristic;
+    return static_cast<int>(m_heuristicWeight * heuristic);
+}
+
+inline int AStar::getOpenMaxCost() const
+{
+    // f values of a weighted heuristic can decrease along a path
+    if (m_heuristicWeight > 1)
+        return -1;
+    return m_env->getMaxCost();
 }
 
 StatisticsCollection AStar::createStatistics()
 {
-    StatisticsCollection collection;
-    collection.create("cpu_time");
-    collection.create("path_cost");
-    collection.create("path_length");
-    collection.create("branching_factor");
-    collection.create("nodes_expanded");
-    collection.create("nodes_visited");
-    collection.create("open_length");
-    //    collection.create("closed_length");
-    collection.create("open_max");
-    return collection;
+    return createBasicStatistics();
+}
+
+int AStar::computePathCost(const vector<int>& path) const
+{
+    assert(! path.empty());
+    int cost = 0;
+    for (vector<int>::size_type i = path.size() - 1; i > 0; --i)
+    {
+        EdgeCostFinder finder(path[i - 1]);
+        m_env->visitSuccessors(path[i], NO_NODE, finder);
+        assert(finder.getCost() >= 0);
+        cost += finder.getCost();
+    }
+    return cost;
+}
+
+void AStar::createLists(OpenListType openListType)
+{
+    switch (m_closedListType)
+    {
+    case CLOSED_LIST:
+        m_closed.reset(new ClosedList());
+        break;
+    case CLOSED_PERFECT_HASH:
+        m_closed.reset(new ClosedListPerfectHash());
+        break;
+    case CLOSED_NODE_STATES:
+    case CLOSED_SPARSE_HASH:
+    case CLOSED_AUTO:
+        break;
+    }
+    switch (openListType)
+    {
+    case OPEN_MULTISET:
+        m_open.reset(new OpenQueue());
+        break;
+    case OPEN_BINARY_HEAP:
+        m_open.reset(new OpenBinaryHeap());
+        break;
+    case OPEN_PAIRING_HEAP:
+        m_open.reset(new OpenPairingHeap());
+        break;
+    case OPEN_BUCKETS:
+        m_open.reset(new OpenBucketQueue());
+        break;
+    }
 }
 
 const AStar::AStarNode* AStar::findNode(int nodeId)
 {
     const AStarNode* result = 0;
-    result = m_open.search(nodeId);
+    result = m_open->search(nodeId);
     if (result != 0)
         return result;
     result = m_closed->search(nodeId);
     return result;
 }
 
-bool AStar::findPath(const Environment& env, int start, int target)
+void AStar::begin(const Environment& env, int start, int target)
 {
     assert(env.isValidNodeId(start));
     assert(env.isValidNodeId(target));
@@ -278,91 +1020,440 @@ bool AStar::findPath(const Environment& env, int start, int target)
     m_nodesExpanded = 0;
     m_nodesVisited = 0;
     m_env = &env;
+    m_numberNodes = env.getNumberNodes();
+    clearTrace();
+    m_start = start;
     m_target = target;
     m_path.clear();
-    m_visitedNodes.resize(env.getNumberNodes());
-    for (vector<char>::iterator i = m_visitedNodes.begin();
-         i != m_visitedNodes.end(); ++i)
-        *i = ' ';
-    findPathAStar(start);
-    double timeDiff =
+    m_pathCost = NO_COST;
+    m_isAborted = false;
+    m_isSearching = true;
+    m_maxOpen = 0;
+    m_useFocal =
+        (m_suboptimalMode == SUBOPTIMAL_FOCAL && m_suboptimalityBound > 1);
+    m_heuristicWeight =
+        (m_suboptimalMode == SUBOPTIMAL_WEIGHTED ? m_suboptimalityBound : 1);
+    m_useSparseHash =
+        (! m_useFocal
+         && (m_closedListType == CLOSED_SPARSE_HASH
+             || (m_closedListType == CLOSED_AUTO
+                 && env.getNumberNodes() >= SPARSE_HASH_MIN_NODES)));
+    if (m_useFocal)
+        initFocal();
+    else if (m_useSparseHash)
+        initSparseHash();
+    else if (m_closedListType == CLOSED_NODE_STATES
+             || m_closedListType == CLOSED_AUTO)
+        initNodeStates();
+    else
+        initAStar();
+    m_cpuTime =
         static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
-    m_statistics.get("cpu_time").add(timeDiff);
-    m_statistics.get("nodes_expanded").add(m_nodesExpanded);
-    m_statistics.get("nodes_visited").add(m_nodesVisited);
-    m_statistics.get("path_length").add(m_path.size());
-    return true;
 }
 
-void AStar::findPathAStar(int start)
+void AStar::cancel()
+{
+    if (! m_isSearching)
+        return;
+    m_isAborted = true;
+    finishStatistics();
+}
+
+bool AStar::findPath(const Environment& env, int start, int target)
+{
+    begin(env, start, target);
+    step(-1);
+    return ! m_isAborted;
+}
+
+void AStar::finishStatistics()
+{
+    m_isSearching = false;
+    m_cpuTimeStatistics.add(m_cpuTime);
+    m_nodesExpandedStatistics.add(m_nodesExpanded);
+    m_nodesVisitedStatistics.add(m_nodesVisited);
+    m_pathLengthStatistics.add(m_path.size());
+}
+
+void AStar::initAStar()
 {
-    int maxopen = 0;
-    //    int closedsize = 0;
     int numberNodes = m_env->getNumberNodes();
     m_closed->init(numberNodes);
-    m_open.init(numberNodes);
-    int heuristic = m_env->getHeuristic(start, m_target);
-    m_pathCost = NO_COST;
-    AStarNode startNode(start, NO_NODE, 0, heuristic);
-    m_open.insert(startNode);
-    vector<Environment::Successor> successors;
-    while (! m_open.isEmpty())
+    m_open->init(numberNodes, getOpenMaxCost());
+    int heuristic = getHeuristic(m_start);
+    AStarNode startNode(m_start, NO_NODE, 0, heuristic);
+    m_open->insert(startNode);
+}
+
+void AStar::initFocal()
+{
+    m_nodeStates.init(m_env->getNumberNodes());
+    m_lazyOpen.init();
+    m_focal.init();
+    m_focalWait.init();
+    int heuristic = getHeuristic(m_start);
+    m_nodeStates.setOpen(m_start, 0, NO_NODE);
+    m_lazyOpen.insert(m_start, 0, heuristic);
+    m_focal.insert(m_start, 0, heuristic);
+    m_focalBound = heuristic;
+    m_openSize = 1;
+}
+
+void AStar::initNodeStates()
+{
+    int numberNodes = m_env->getNumberNodes();
+    m_nodeStates.init(numberNodes);
+    m_open->init(numberNodes, getOpenMaxCost());
+    int heuristic = getHeuristic(m_start);
+    AStarNode startNode(m_start, NO_NODE, 0, heuristic);
+    m_nodeStates.setOpen(m_start, 0, NO_NODE);
+    m_open->insert(startNode);
+}
+
+void AStar::initSparseHash()
+{
+    m_nodeTable.init();
+    m_lazyOpen.init();
+    int heuristic = getHeuristic(m_start);
+    m_nodeTable.setOpen(m_nodeTable.lookup(m_start), 0, NO_NODE);
+    m_lazyOpen.insert(m_start, 0, heuristic);
+    m_openSize = 1;
+}
+
+AStar::StepResult AStar::step(long long int maxExpansions)
+{
+    assert(m_isSearching);
+    clock_t startTime = clock();
+    long long int maxNodesExpanded = -1;
+    if (maxExpansions >= 0)
+        maxNodesExpanded = m_nodesExpanded + maxExpansions;
+    StepResult result;
+    if (m_useFocal)
+        result = stepFocal(maxNodesExpanded);
+    else if (m_useSparseHash)
+        result = stepSparseHash(maxNodesExpanded);
+    else if (m_closedListType == CLOSED_NODE_STATES
+             || m_closedListType == CLOSED_AUTO)
+        result = stepNodeStates(maxNodesExpanded);
+    else
+        result = stepAStar(maxNodesExpanded);
+    m_cpuTime += static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
+    if (result != STEP_IN_PROGRESS)
+        finishStatistics();
+    return result;
+}
+
+AStar::StepResult AStar::stepAStar(long long int maxNodesExpanded)
+{
+    while (! m_open->isEmpty())
     {
-        m_statistics.get("open_length").add(m_open.getSize());
-        if (m_open.getSize() > maxopen)
-             maxopen = m_open.getSize();
+        if (isStepFinished(maxNodesExpanded))
+            return STEP_IN_PROGRESS;
+        if (SAMPLE_EXPANSIONS)
+        {
+            int openSize = m_open->getSize();
+            m_openLengthStatistics.add(openSize);
+            if (openSize > m_maxOpen)
+                m_maxOpen = openSize;
+        }
         //m_open.print(cout);
         AStarNode node = getBestNodeFromOpen();
         //cout << '[';  node.print(cout); cout << ']' << endl;
         if (node.m_nodeId == m_target)
         {
-            finishSearch(start, node);
-            return;
+            finishSearch(m_start, node);
+            return STEP_FOUND;
         }
-        ++m_nodesExpanded;
-        m_env->getSuccessors(node.m_nodeId, NO_NODE, successors);
-        m_branchingFactor.add(successors.size());
-        for (vector<Environment::Successor>::const_iterator i
-                 = successors.begin(); i != successors.end(); ++i)
+        if (isNodesLimitReached())
         {
-            int newg = node.m_g + i->m_cost;
-            int target = i->m_target;
-            const AStarNode* targetAStarNode = findNode(target);
-            if (targetAStarNode != 0)
-            {
-                if (newg >= targetAStarNode->m_g)
-                    continue;
-                if (! m_open.remove(target))
-                    m_closed->remove(target);
-            }
-            int newHeuristic = m_env->getHeuristic(target, m_target);
-            AStarNode newAStarNode(target, node.m_nodeId, newg, newHeuristic);
-            m_open.insert(newAStarNode);
+            m_isAborted = true;
+            break;
         }
-        //        closedsize++;
+        ++m_nodesExpanded;
+        m_expandedNodeId = node.m_nodeId;
+        m_expandedG = node.m_g;
+        Relaxer<&AStar::relaxAStar> relaxer(*this);
+        m_env->visitSuccessors(node.m_nodeId, NO_NODE, relaxer);
+        if (SAMPLE_EXPANSIONS)
+            m_branchingFactor.add(relaxer.getNumberSuccessors());
         m_closed->add(node);
-        //        m_statistics.get("closed_length").add(m_closed.size());
         //closed->print(cout);
     }
-    m_statistics.get("open_max").add(maxopen);
+    if (SAMPLE_EXPANSIONS)
+        m_openMaxStatistics.add(m_maxOpen);
+    return STEP_FAILED;
+}
+
+AStar::StepResult AStar::stepFocal(long long int maxNodesExpanded)
+{
+    NodeStateArray& nodeStates = m_nodeStates;
+    while (updateFocal())
+    {
+        if (isStepFinished(maxNodesExpanded))
+            return STEP_IN_PROGRESS;
+        // The node with lowest f is always in the focal list
+        assert(! m_focal.isEmpty());
+        int nodeId;
+        int g;
+        int h;
+        m_focal.pop(nodeId, g, h);
+        if (! isOpenEntry(nodeStates, nodeId, g))
+            continue; // outdated entry
+        if (g + h > m_focalBound)
+        {
+            // Only possible if the lowest f decreased
+            m_focalWait.insert(nodeId, g, g + h);
+            continue;
+        }
+        if (SAMPLE_EXPANSIONS)
+        {
+            m_openLengthStatistics.add(m_openSize);
+            if (m_openSize > m_maxOpen)
+                m_maxOpen = m_openSize;
+        }
+        --m_openSize;
+        ++m_nodesVisited;
+        traceVisited(nodeId);
+        nodeStates.setClosed(nodeId);
+        if (nodeId == m_target)
+        {
+            setPath(nodeStates.constructPath(m_start, m_target), g);
+            return STEP_FOUND;
+        }
+        if (isNodesLimitReached())
+        {
+            m_isAborted = true;
+            break;
+        }
+        ++m_nodesExpanded;
+        m_expandedNodeId = nodeId;
+        m_expandedG = g;
+        Relaxer<&AStar::relaxFocal> relaxer(*this);
+        m_env->visitSuccessors(nodeId, NO_NODE, relaxer);
+        if (SAMPLE_EXPANSIONS)
+            m_branchingFactor.add(relaxer.getNumberSuccessors());
+    }
+    if (SAMPLE_EXPANSIONS)
+        m_openMaxStatistics.add(m_maxOpen);
+    return STEP_FAILED;
+}
+
+AStar::StepResult AStar::stepNodeStates(long long int maxNodesExpanded)
+{
+    NodeStateArray& nodeStates = m_nodeStates;
+    while (! m_open->isEmpty())
+    {
+        if (isStepFinished(maxNodesExpanded))
+            return STEP_IN_PROGRESS;
+        if (SAMPLE_EXPANSIONS)
+        {
+            int openSize = m_open->getSize();
+            m_openLengthStatistics.add(openSize);
+            if (openSize > m_maxOpen)
+                m_maxOpen = openSize;
+        }
+        AStarNode node = getBestNodeFromOpen();
+        nodeStates.setClosed(node.m_nodeId);
+        if (node.m_nodeId == m_target)
+        {
+            setPath(nodeStates.constructPath(m_start, m_target), node.m_g);
+            return STEP_FOUND;
+        }
+        if (isNodesLimitReached())
+        {
+            m_isAborted = true;
+            break;
+        }
+        ++m_nodesExpanded;
+        m_expandedNodeId = node.m_nodeId;
+        m_expandedG = node.m_g;
+        Relaxer<&AStar::relaxNodeStates> relaxer(*this);
+        m_env->visitSuccessors(node.m_nodeId, NO_NODE, relaxer);
+        if (SAMPLE_EXPANSIONS)
+            m_branchingFactor.add(relaxer.getNumberSuccessors());
+    }
+    if (SAMPLE_EXPANSIONS)
+        m_openMaxStatistics.add(m_maxOpen);
+    return STEP_FAILED;
+}
+
+AStar::StepResult AStar::stepSparseHash(long long int maxNodesExpanded)
+{
+    NodeHashTable& nodeTable = m_nodeTable;
+    BasicOpenHeap& open = m_lazyOpen;
+    while (! open.isEmpty())
+    {
+        if (isStepFinished(maxNodesExpanded))
+            return STEP_IN_PROGRESS;
+        int nodeId;
+        int g;
+        int f;
+        open.pop(nodeId, g, f);
+        int slot = nodeTable.find(nodeId);
+        assert(slot >= 0);
+        if (nodeTable.getState(slot) != NodeStateArray::OPEN
+            || nodeTable.getG(slot) != g)
+            continue; // outdated entry
+        if (SAMPLE_EXPANSIONS)
+        {
+            m_openLengthStatistics.add(m_openSize);
+            if (m_openSize > m_maxOpen)
+                m_maxOpen = m_openSize;
+        }
+        --m_openSize;
+        ++m_nodesVisited;
+        traceVisited(nodeId);
+        nodeTable.setClosed(slot);
+        if (nodeId == m_target)
+        {
+            setPath(nodeTable.constructPath(m_start, m_target), g);
+            return STEP_FOUND;
+        }
+        if (isNodesLimitReached())
+        {
+            m_isAborted = true;
+            break;
+        }
+        ++m_nodesExpanded;
+        m_expandedNodeId = nodeId;
+        m_expandedG = g;
+        Relaxer<&AStar::relaxSparseHash> relaxer(*this);
+        m_env->visitSuccessors(nodeId, NO_NODE, relaxer);
+        if (SAMPLE_EXPANSIONS)
+            m_branchingFactor.add(relaxer.getNumberSuccessors());
+    }
+    if (SAMPLE_EXPANSIONS)
+        m_openMaxStatistics.add(m_maxOpen);
+    return STEP_FAILED;
+}
+
+void AStar::relaxAStar(int target, int cost)
+{
+    int newg = m_expandedG + cost;
+    const AStarNode* targetAStarNode = findNode(target);
+    if (targetAStarNode != 0)
+        if (newg >= targetAStarNode->m_g)
+            return;
+    int newHeuristic = getHeuristic(target);
+    AStarNode newAStarNode(target, m_expandedNodeId, newg, newHeuristic);
+    if (targetAStarNode != 0)
+    {
+        if (m_open->decreaseKey(newAStarNode))
+            return;
+        m_closed->remove(target);
+    }
+    m_open->insert(newAStarNode);
+}
+
+void AStar::relaxNodeStates(int target, int cost)
+{
+    int newg = m_expandedG + cost;
+    NodeStateArray::State state = m_nodeStates.getState(target);
+    if (state != NodeStateArray::UNSEEN
+        && newg >= m_nodeStates.getG(target))
+        return;
+    m_nodeStates.setOpen(target, newg, m_expandedNodeId);
+    int newHeuristic = getHeuristic(target);
+    AStarNode newAStarNode(target, m_expandedNodeId, newg, newHeuristic);
+    if (state == NodeStateArray::OPEN)
+        m_open->decreaseKey(newAStarNode);
+    else
+        m_open->insert(newAStarNode);
+}
+
+void AStar::relaxSparseHash(int target, int cost)
+{
+    int newg = m_expandedG + cost;
+    int targetSlot = m_nodeTable.lookup(target);
+    NodeStateArray::State state = m_nodeTable.getState(targetSlot);
+    if (state != NodeStateArray::UNSEEN
+        && newg >= m_nodeTable.getG(targetSlot))
+        return;
+    m_nodeTable.setOpen(targetSlot, newg, m_expandedNodeId);
+    if (state != NodeStateArray::OPEN)
+        ++m_openSize;
+    int newHeuristic = getHeuristic(target);
+    m_lazyOpen.insert(target, newg, newg + newHeuristic);
+}
+
+void AStar::relaxFocal(int target, int cost)
+{
+    int newg = m_expandedG + cost;
+    NodeStateArray::State state = m_nodeStates.getState(target);
+    if (state != NodeStateArray::UNSEEN
+        && newg >= m_nodeStates.getG(target))
+        return;
+    m_nodeStates.setOpen(target, newg, m_expandedNodeId);
+    if (state != NodeStateArray::OPEN)
+        ++m_openSize;
+    int newHeuristic = getHeuristic(target);
+    int newf = newg + newHeuristic;
+    m_lazyOpen.insert(target, newg, newf);
+    if (newf <= m_focalBound)
+        m_focal.insert(target, newg, newHeuristic);
+    else
+        m_focalWait.insert(target, newg, newf);
+}
+
+void AStar::setSuboptimalityBound(double bound, SuboptimalMode mode)
+{
+    if (bound < 1)
+        throw Error("Suboptimality bound must be at least 1.");
+    m_suboptimalityBound = bound;
+    m_suboptimalMode = mode;
+}
+
+bool AStar::updateFocal()
+{
+    int nodeId;
+    int g;
+    int f;
+    while (true)
+    {
+        if (m_lazyOpen.isEmpty())
+            return false;
+        m_lazyOpen.top(nodeId, g, f);
+        if (isOpenEntry(m_nodeStates, nodeId, g))
+            break;
+        m_lazyOpen.pop(nodeId, g, f);
+    }
+    m_focalBound = static_cast<int>(m_suboptimalityBound * f);
+    while (! m_focalWait.isEmpty())
+    {
+        m_focalWait.top(nodeId, g, f);
+        if (f > m_focalBound)
+            break;
+        m_focalWait.pop(nodeId, g, f);
+        if (isOpenEntry(m_nodeStates, nodeId, g))
+            m_focal.insert(nodeId, g, f - g);
+    }
+    return true;
 }
 
 void AStar::finishSearch(int start, const AStarNode& node)
 {
     m_closed->add(node);
-    m_path = m_closed->constructPath(start, m_target);
-    m_pathCost = node.m_f;
-    m_statistics.get("path_cost").add(m_pathCost);
+    setPath(m_closed->constructPath(start, m_target), node.m_g);
+}
+
+void AStar::setPath(const vector<int>& path, int targetG)
+{
+    m_path = path;
+    if (m_useFocal || m_heuristicWeight > 1)
+        m_pathCost = computePathCost(m_path);
+    else
+        m_pathCost = targetG;
+    m_pathCostStatistics.add(m_pathCost);
 }
 
 AStar::AStarNode AStar::getBestNodeFromOpen()
 {
-    assert(! m_open.isEmpty());
-    AStarNode result = m_open.pop();
+    assert(! m_open->isEmpty());
+    AStarNode result = m_open->pop();
     int nodeId = result.m_nodeId;
     assert(nodeId >= 0);
     ++m_nodesVisited;
-    m_visitedNodes[nodeId] = '+';
+    traceVisited(nodeId);
     return result;
 }
 
@@ -371,4 +1462,9 @@ const StatisticsCollection& AStar::getStatistics() const
     return m_statistics;
 }
 
+const vector<char>& AStar::getVisitedNodes() const
+{
+    return getVisitedNodeLabels(m_numberNodes);
+}
+
 //-----------------------------------------------------------------------------
@@ -44,6 +44,9 @@
 #include <memory>
 #include <queue>
 #include <set>
+#include "basicastar.h"
+#include "markerarray.h"
+#include "nodestatearray.h"
 #include "search.h"
 
 //-----------------------------------------------------------------------------
@@ -57,12 +60,127 @@ namespace PathFind
         : public Search
     {
     public:
-        explicit AStar(bool usePerfectHashClosedList);
+        /** Data structure used for the open list. */
+        typedef enum {
+            /** std::multiset with lookup table by node id. */
+            OPEN_MULTISET,
+
+            /** Indexed binary heap with in-place decrease-key. */
+            OPEN_BINARY_HEAP,
+
+            /** Indexed pairing heap with in-place decrease-key. */
+            OPEN_PAIRING_HEAP,
+
+            /** Circular array of buckets indexed by f value.
+                Requires integer costs and a consistent heuristic.
+                Falls back to OPEN_BINARY_HEAP if the maximum edge cost of
+                the environment needs more than MAX_BUCKETS buckets.
+                Nodes with equal f are popped in LIFO order, so paths can
+                differ from the other open lists, but have the same cost.
+            */
+            OPEN_BUCKETS
+        } OpenListType;
+
+        /** Data structure used for the closed list. */
+        typedef enum {
+            /** std::list with linear search. */
+            CLOSED_LIST,
+
+            /** Array of nodes indexed by node id. */
+            CLOSED_PERFECT_HASH,
+
+            /** Parallel arrays for g, parent and open/closed state indexed
+                by node id.
+                Replaces the lookups in the open and closed list for each
+                successor by direct array accesses.
+            */
+            CLOSED_NODE_STATES,
+
+            /** Node states in an open addressing hash table, with an open
+                list that finds its nodes through the hash table.
+                Memory grows with the number of nodes reached by a search,
+                not with the number of nodes of the environment.
+                The open list type given to the constructor is not used.
+            */
+            CLOSED_SPARSE_HASH,
+
+            /** CLOSED_SPARSE_HASH for environments with at least
+                SPARSE_HASH_MIN_NODES nodes, otherwise CLOSED_NODE_STATES.
+            */
+            CLOSED_AUTO
+        } ClosedListType;
+
+        /** Number of nodes from which CLOSED_AUTO uses CLOSED_SPARSE_HASH. */
+        static const int SPARSE_HASH_MIN_NODES = 1 << 22;
+
+        /** Search used for a suboptimality bound larger than 1.
+            Both find paths that cost at most the bound times the optimal
+            path cost, if the heuristic is admissible.
+        */
+        typedef enum {
+            /** Weighted A*, nodes are ordered by g + bound * h.
+                Works with all open and closed list types, OPEN_BUCKETS
+                uses its binary heap, because the weighted heuristic is
+                not consistent.
+            */
+            SUBOPTIMAL_WEIGHTED,
+
+            /** Focal search (A*-epsilon).
+                Expands the node with the lowest h among the open nodes
+                with f not larger than bound times the lowest f.
+                Always uses node states indexed by node id and lazy open
+                lists, the list types given to the constructor are not
+                used.
+            */
+            SUBOPTIMAL_FOCAL
+        } SuboptimalMode;
+
+        /** Result of step(). */
+        typedef enum {
+            /** The expansion budget was used, call step() again. */
+            STEP_IN_PROGRESS,
+
+            /** A path was found. */
+            STEP_FOUND,
+
+            /** There is no path, or the node limit was reached. */
+            STEP_FAILED
+        } StepResult;
+
+        /** Construct with CLOSED_PERFECT_HASH or CLOSED_LIST. */
+        explicit AStar(bool usePerfectHashClosedList,
+                       OpenListType openListType = OPEN_MULTISET);
+
+        explicit AStar(ClosedListType closedListType,
+                       OpenListType openListType = OPEN_MULTISET);
+
+        /** Start a search that is run by calls to step().
+            A search started before that was not finished is replaced.
+            The environment must not change until the search is finished.
+        */
+        void begin(const Environment& env, int start, int target);
+
+        /** Stop the search started with begin().
+            Has the same effect as reaching the node limit, the statistics
+            contain the work done so far. Does nothing if the search is
+            already finished.
+        */
+        void cancel();
 
         StatisticsCollection createStatistics();
 
+        /** Find a path.
+            Same as begin() followed by step() without expansion limit.
+            @return false, if search was aborted due to node limit.
+        */
         bool findPath(const Environment& env, int start, int target);
 
+        /** Number of nodes expanded by the current or last search. */
+        long long int getNodesExpanded() const
+        {
+            return m_nodesExpanded;
+        }
+
         const vector<int>& getPath() const
         {
             return m_path;
@@ -70,11 +188,10 @@ namespace PathFind
 
         const StatisticsCollection& getStatistics() const;
 
-        /** Get a vector with 'x' char labels for each visited node. */
-        const vector<char>& getVisitedNodes() const
-        {
-            return m_visitedNodes;
-        }
+        /** Get a vector with '+' char labels for each visited node.
+            @see Search::getVisitedNodes
+        */
+        const vector<char>& getVisitedNodes() const;
 
         void setNodesLimit(long long int nodesLimit)
         {
@@ -86,6 +203,37 @@ namespace PathFind
             return m_pathCost;
         }
 
+        double getSuboptimalityBound() const
+        {
+            return m_suboptimalityBound;
+        }
+
+        SuboptimalMode getSuboptimalMode() const
+        {
+            return m_suboptimalMode;
+        }
+
+        /** Allow paths that are more expensive than the optimal path.
+            @param bound Maximum factor between the cost of the path found
+            and the optimal path cost. The default is 1 (optimal paths).
+            @param mode The search used if bound is larger than 1.
+            Closed nodes are reopened if they are reached with a lower g
+            value. Nodes on the path can therefore have a lower g value
+            than when the target was reached through them, so the path
+            cost is computed along the path in these modes.
+            @throws Error, if bound is smaller than 1.
+        */
+        void setSuboptimalityBound(double bound,
+                                   SuboptimalMode mode = SUBOPTIMAL_WEIGHTED);
+
+        /** Continue the search started with begin().
+            Path, path cost and statistics are available after the result
+            is STEP_FOUND or STEP_FAILED.
+            @param maxExpansions Maximum number of nodes expanded in this
+            call, -1 for no limit.
+        */
+        StepResult step(long long int maxExpansions);
+
     private:
         class AStarNode
         {
@@ -96,7 +244,7 @@ namespace PathFind
                 virtual ~Compare();
 
                 bool operator()(const AStarNode& node1,
-                                const AStarNode& node2);
+                                const AStarNode& node2) const;
             };
 
             int m_nodeId;
@@ -183,25 +331,164 @@ namespace PathFind
         private:
             int m_maxNodeId;
 
-            vector<bool> m_marker;
+            MarkerArray m_marker;
 
             vector<AStarNode> m_nodes;            
         };
 
-        class OpenQueue
+        /** Search state of nodes in an open addressing hash table.
+            Nodes are addressed by their slot in the table, which is valid
+            until the next call of lookup().
+            Like NodeStateArray, the table is cleared in constant time.
+        */
+        class NodeHashTable
         {
         public:
-            OpenQueue();
+            NodeHashTable();
 
-            void init(int numberNodes);
+            vector<int> constructPath(int start, int target) const;
 
-            void insert(const AStarNode& node);
+            /** @return Slot of node or -1, if node is not in table. */
+            int find(int nodeId) const;
+
+            int getG(int slot) const
+            {
+                assert(getState(slot) != NodeStateArray::UNSEEN);
+                return m_slots[slot].m_g;
+            }
+
+            NodeStateArray::State getState(int slot) const
+            {
+                assert(slot >= 0 && slot < getNumberSlots());
+                assert(m_slots[slot].m_state >= m_base);
+                return static_cast<NodeStateArray::State>(
+                                         m_slots[slot].m_state - m_base);
+            }
+
+            /** Initialize for search.
+                Removes all nodes, keeps the size of the table.
+            */
+            void init();
+
+            /** Find node or add it in state UNSEEN.
+                @return Slot of node.
+            */
+            int lookup(int nodeId);
+
+            void setClosed(int slot)
+            {
+                assert(getState(slot) == NodeStateArray::OPEN);
+                m_slots[slot].m_state = m_base + NodeStateArray::CLOSED;
+            }
+
+            void setOpen(int slot, int g, int parent)
+            {
+                assert(slot >= 0 && slot < getNumberSlots());
+                Slot& entry = m_slots[slot];
+                entry.m_state = m_base + NodeStateArray::OPEN;
+                entry.m_g = g;
+                entry.m_parent = parent;
+            }
+
+        private:
+            class Slot
+            {
+            public:
+                int m_nodeId;
+
+                int m_g;
+
+                int m_parent;
+
+                /** State value relative to m_base.
+                    Smaller values than m_base are empty slots.
+                */
+                unsigned int m_state;
+            };
+
+            static const int MIN_SLOTS_LOG2 = 10;
+
+            /** State value for UNSEEN in the current search, never 0. */
+            unsigned int m_base;
+
+            int m_numberUsed;
+
+            /** 32 minus the log2 of the number of slots. */
+            int m_shift;
+
+            vector<Slot> m_slots;
+
+            int getNumberSlots() const
+            {
+                return m_slots.size();
+            }
+
+            int getStartSlot(int nodeId) const
+            {
+                return (static_cast<unsigned int>(nodeId) * 2654435769U)
+                    >> m_shift;
+            }
+
+            /** Double the number of slots. */
+            void grow();
+
+            bool isUsed(int slot) const
+            {
+                return (m_slots[slot].m_state >= m_base);
+            }
+        };
+
+        class OpenListBase
+        {
+        public:
+            virtual ~OpenListBase();
+
+            /** Replace a node in the open list by a node with the same id
+                and a lower f value.
+                @return false, if the node is not in the open list.
+            */
+            virtual bool decreaseKey(const AStarNode& node) = 0;
+
+            virtual int getSize() const = 0;
+
+            /** Initialize for search.
+                Must be called before using the open list.
+                @param maxCost The maximum edge cost of the environment,
+                or -1 if the heuristic is not consistent.
+            */
+            virtual void init(int numberNodes, int maxCost) = 0;
+
+            virtual void insert(const AStarNode& node) = 0;
 
             bool isEmpty() const
             {
-                return (m_nodes.size() == 0);
+                return (getSize() == 0);
             }
 
+            /** Remove the node with lowest f value.
+                Ties are broken in favor of larger g values and then in
+                favor of the node that was inserted or decreased first.
+            */
+            virtual AStarNode pop() = 0;
+
+            virtual bool remove(int nodeId) = 0;
+
+            virtual const AStarNode* search(int nodeId) const = 0;
+        };
+
+        /** Open list implemented using a multiset. */
+        class OpenQueue
+            : public OpenListBase
+        {
+        public:
+            OpenQueue();
+
+            bool decreaseKey(const AStarNode& node);
+
+            void init(int numberNodes, int maxCost);
+
+            void insert(const AStarNode& node);
+
             AStarNode pop();
 
             void print(ostream& ostrm) const;
@@ -224,7 +511,7 @@ namespace PathFind
 
             int m_numberNodes;
 
-            vector<bool> m_marker;
+            MarkerArray m_marker;
 
             /** Iterator in m_nodes by nodeId. */
             vector<NodeSetIterator> m_lookupTable;
@@ -232,10 +519,230 @@ namespace PathFind
             NodeSet m_nodes;
         };
 
+        /** Base class for open lists that store nodes indexed by node id.
+            The node arrays are only reallocated if the number of nodes
+            changes, so searches on the same environment do not allocate.
+        */
+        class OpenIndexedBase
+            : public OpenListBase
+        {
+        public:
+            OpenIndexedBase();
+
+            const AStarNode* search(int nodeId) const;
+
+        protected:
+            int m_numberNodes;
+
+            /** Sequence number of the next insert or decrease-key.
+                Used for breaking ties in the same order as OpenQueue.
+            */
+            int m_nextSequence;
+
+            MarkerArray m_marker;
+
+            vector<int> m_sequence;
+
+            vector<AStarNode> m_nodes;
+
+            bool isBetter(int nodeId1, int nodeId2) const;
+
+            /** Store node and assign it a new sequence number. */
+            void setNode(const AStarNode& node);
+        };
+
+        /** Open list implemented using an indexed binary heap. */
+        class OpenBinaryHeap
+            : public OpenIndexedBase
+        {
+        public:
+            bool decreaseKey(const AStarNode& node);
+
+            int getSize() const
+            {
+                return m_heap.size();
+            }
+
+            void init(int numberNodes, int maxCost);
+
+            void insert(const AStarNode& node);
+
+            AStarNode pop();
+
+            void print(ostream& ostrm) const;
+
+            bool remove(int nodeId);
+
+        private:
+            /** Node ids in heap order. */
+            vector<int> m_heap;
+
+            /** Index in m_heap by nodeId. */
+            vector<int> m_position;
+
+            void moveDown(int position);
+
+            void moveUp(int position);
+
+            void place(int nodeId, int position)
+            {
+                m_heap[position] = nodeId;
+                m_position[nodeId] = position;
+            }
+        };
+
+        /** Open list implemented using an indexed pairing heap. */
+        class OpenPairingHeap
+            : public OpenIndexedBase
+        {
+        public:
+            OpenPairingHeap();
+
+            bool decreaseKey(const AStarNode& node);
+
+            int getSize() const
+            {
+                return m_size;
+            }
+
+            void init(int numberNodes, int maxCost);
+
+            void insert(const AStarNode& node);
+
+            AStarNode pop();
+
+            void print(ostream& ostrm) const;
+
+            bool remove(int nodeId);
+
+        private:
+            int m_root;
+
+            int m_size;
+
+            /** First child by nodeId. */
+            vector<int> m_child;
+
+            /** Next sibling by nodeId. */
+            vector<int> m_next;
+
+            /** Previous sibling, or parent for first child, by nodeId. */
+            vector<int> m_previous;
+
+            /** Work space for combineSiblings. */
+            vector<int> m_subtrees;
+
+            /** Meld the subtrees in the sibling list starting at nodeId.
+                @return The root of the resulting tree.
+            */
+            int combineSiblings(int nodeId);
+
+            /** Detach subtree at nodeId from its parent and siblings. */
+            void cut(int nodeId);
+
+            /** Meld two trees.
+                @return The root of the resulting tree.
+            */
+            int meld(int nodeId1, int nodeId2);
+        };
+
+        /** Open list implemented as a bucket queue.
+            With a consistent heuristic, all f values in the open list lie
+            within 2 * maxCost of the lowest one, so a circular array of
+            2 * maxCost + 1 buckets is enough.
+            Uses a binary heap if maxCost is -1.
+        */
+        class OpenBucketQueue
+            : public OpenIndexedBase
+        {
+        public:
+            static const int MAX_BUCKETS = 1024;
+
+            OpenBucketQueue();
+
+            bool decreaseKey(const AStarNode& node);
+
+            int getSize() const
+            {
+                if (m_useHeap)
+                    return m_heap.getSize();
+                return m_size;
+            }
+
+            void init(int numberNodes, int maxCost);
+
+            void insert(const AStarNode& node);
+
+            AStarNode pop();
+
+            void print(ostream& ostrm) const;
+
+            bool remove(int nodeId);
+
+            const AStarNode* search(int nodeId) const;
+
+        private:
+            bool m_useHeap;
+
+            /** Lower bound for the f values in the queue. */
+            int m_minF;
+
+            int m_size;
+
+            /** First node in bucket (f modulo number buckets). */
+            vector<int> m_buckets;
+
+            /** Next node in bucket by nodeId. */
+            vector<int> m_next;
+
+            /** Previous node in bucket by nodeId. */
+            vector<int> m_previous;
+
+            /** Used if the range of f values is too large for buckets. */
+            OpenBinaryHeap m_heap;
+
+            int getBucket(int f) const
+            {
+                return f % static_cast<int>(m_buckets.size());
+            }
+
+            void link(int nodeId);
+
+            void unlink(int nodeId);
+        };
+
+        ClosedListType m_closedListType;
+
+        /** Whether the last search was aborted due to node limit. */
+        bool m_isAborted;
+
+        /** Whether a search was started with begin() and not finished. */
+        bool m_isSearching;
+
+        /** Whether the current search uses stepFocal. */
+        bool m_useFocal;
+
+        SuboptimalMode m_suboptimalMode;
+
+        double m_suboptimalityBound;
+
+        /** Factor for the heuristic in the current search.
+            The suboptimality bound for SUBOPTIMAL_WEIGHTED, otherwise 1.
+        */
+        double m_heuristicWeight;
+
         int m_pathCost;
 
+        int m_start;
+
         int m_target;
 
+        /** Largest open list length in the current search. */
+        int m_maxOpen;
+
+        /** CPU time of the current search in seconds. */
+        double m_cpuTime;
+
         const Environment* m_env;
 
         long long int m_nodesExpanded;
@@ -244,24 +751,189 @@ namespace PathFind
 
         auto_ptr<ClosedListBase> m_closed;
 
-        vector<char> m_visitedNodes;
+        /** Used instead of m_closed for CLOSED_NODE_STATES. */
+        NodeStateArray m_nodeStates;
+
+        /** Used instead of m_closed for CLOSED_SPARSE_HASH. */
+        NodeHashTable m_nodeTable;
+
+        /** Open list for CLOSED_SPARSE_HASH. */
+        BasicOpenHeap m_lazyOpen;
+
+        /** Whether the last search used CLOSED_SPARSE_HASH. */
+        bool m_useSparseHash;
+
+        /** Number of nodes of the environment in the last search. */
+        int m_numberNodes;
+
+        /** Node currently expanded, used by the relax functions. */
+        int m_expandedNodeId;
+
+        /** G value of the node currently expanded. */
+        int m_expandedG;
+
+        /** Number of entries in m_lazyOpen not yet closed. */
+        int m_openSize;
+
+        /** Largest f value of nodes in the focal list for
+            SUBOPTIMAL_FOCAL.
+        */
+        int m_focalBound;
+
+        /** Focal list for SUBOPTIMAL_FOCAL.
+            Ordered by h, the key of the entries is h instead of f.
+        */
+        BasicOpenHeap m_focal;
+
+        /** Open nodes for SUBOPTIMAL_FOCAL with f larger than
+            m_focalBound when they were added.
+        */
+        BasicOpenHeap m_focalWait;
 
         vector<int> m_path;
 
-        OpenQueue m_open;
+        auto_ptr<OpenListBase> m_open;
 
         StatisticsCollection m_statistics;
 
         Statistics& m_branchingFactor;
 
+        Statistics& m_cpuTimeStatistics;
+
+        Statistics& m_nodesExpandedStatistics;
+
+        Statistics& m_nodesVisitedStatistics;
+
+        Statistics& m_openLengthStatistics;
+
+        Statistics& m_openMaxStatistics;
+
+        Statistics& m_pathCostStatistics;
+
+        Statistics& m_pathLengthStatistics;
+
+        /** Compute the cost of a path by looking up its edges.
+            @param path The path from target to start.
+        */
+        int computePathCost(const vector<int>& path) const;
+
+        void createLists(OpenListType openListType);
+
         /** Find a node in open or closed lists. */
         const AStarNode* findNode(int nodeId);
 
-        void findPathAStar(int start);
+        /** Add the statistics of the search after it is finished. */
+        void finishStatistics();
+
+        void initAStar();
+
+        void initFocal();
+
+        void initNodeStates();
+
+        void initSparseHash();
+
+        /** Check if the search must be aborted after visiting a node.
+            @see Search::setNodesLimit
+        */
+        bool isNodesLimitReached() const
+        {
+            return (m_nodesLimit >= 0 && m_nodesVisited > m_nodesLimit);
+        }
+
+        /** Check if the expansion budget of step() is used.
+            @param maxNodesExpanded Value of m_nodesExpanded at which the
+            step ends, -1 for no limit.
+        */
+        bool isStepFinished(long long int maxNodesExpanded) const
+        {
+            return (maxNodesExpanded >= 0
+                    && m_nodesExpanded >= maxNodesExpanded);
+        }
+
+        /** Search loop for CLOSED_LIST and CLOSED_PERFECT_HASH.
+            @param maxNodesExpanded See isStepFinished
+        */
+        StepResult stepAStar(long long int maxNodesExpanded);
+
+        /** Variant of stepAStar for SUBOPTIMAL_FOCAL (focal search). */
+        StepResult stepFocal(long long int maxNodesExpanded);
+
+        /** Variant of stepAStar for CLOSED_NODE_STATES. */
+        StepResult stepNodeStates(long long int maxNodesExpanded);
+
+        /** Variant of stepAStar for CLOSED_SPARSE_HASH. */
+        StepResult stepSparseHash(long long int maxNodesExpanded);
+
+        /** Heuristic to the target multiplied by m_heuristicWeight. */
+        int getHeuristic(int nodeId) const;
+
+        /** Maximum edge cost passed to OpenListBase::init.
+            -1 if the heuristic is weighted.
+        */
+        int getOpenMaxCost() const;
+
+        /** Discard outdated entries from the top of m_lazyOpen, update
+            m_focalBound and move the nodes within the bound from
+            m_focalWait to m_focal.
+            @return false, if there are no open nodes.
+        */
+        bool updateFocal();
+
+        /** Visitor that forwards the successors of the expanded node to
+            one of the relax functions.
+        */
+        template<void (AStar::*RELAX)(int, int)>
+        class Relaxer
+            : public Environment::SuccessorVisitor
+        {
+        public:
+            explicit Relaxer(AStar& search)
+                : m_search(search),
+                  m_numberSuccessors(0)
+            {
+            }
+
+            int getNumberSuccessors() const
+            {
+                return m_numberSuccessors;
+            }
+
+            bool visit(int target, int cost)
+            {
+                ++m_numberSuccessors;
+                (m_search.*RELAX)(target, cost);
+                return true;
+            }
+
+        private:
+            AStar& m_search;
+
+            int m_numberSuccessors;
+        };
+
+        /** Relax a successor of the expanded node in stepAStar. */
+        void relaxAStar(int target, int cost);
+
+        /** Relax a successor of the expanded node in stepNodeStates. */
+        void relaxNodeStates(int target, int cost);
+
+        /** Relax a successor of the expanded node in stepSparseHash. */
+        void relaxSparseHash(int target, int cost);
+
+        /** Relax a successor of the expanded node in stepFocal. */
+        void relaxFocal(int target, int cost);
 
         /** Construct path and set statistics after target node was found. */
         void finishSearch(int start, const AStarNode& node);
 
+        /** Set the path found and sample its cost.
+            @param path The path from target to start.
+            @param targetG The g value of the target, the path cost unless
+            a bounded-suboptimal mode is used.
+        */
+        void setPath(const vector<int>& path, int targetG);
+
         AStarNode getBestNodeFromOpen();
     };
 }
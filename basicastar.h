@@ -0,0 +1,462 @@
+//-----------------------------------------------------------------------------
+/** @file basicastar.h
+    A* search with environment, heuristic and open list bound at compile
+    time.
+
+    BasicAStar is a template, so the successor generation and the
+    heuristic of the environment are called directly and can be inlined,
+    instead of being called through the virtual functions of Environment
+    as in AStar.
+
+    An environment class ENV needs the members:
+    <pre>
+    typedef ... Heuristic; // default heuristic
+    int getNumberNodes() const;
+    template<class VISITOR>
+    void visitSuccessors(int nodeId, VISITOR& visitor) const;
+    </pre>
+    visitSuccessors() calls visitor.visit(target, cost) for each successor
+    and stops if it returns false, like Environment::visitSuccessors, but
+    with the type of the visitor known at compile time.
+    A heuristic is a function object called as heuristic(env, nodeId,
+    target).
+    An open list needs init(), isEmpty(), insert(nodeId, g, f) and
+    pop(nodeId, g, f). It may return outdated entries, which BasicAStar
+    skips.
+*/
+//-----------------------------------------------------------------------------
+
+#ifndef PATHFIND_BASICASTAR_H
+#define PATHFIND_BASICASTAR_H
+
+#include <algorithm>
+#include <vector>
+#include "environment.h"
+#include "nodestatearray.h"
+#include "search.h"
+#include "statistics.h"
+
+//-----------------------------------------------------------------------------
+
+namespace PathFind
+{
+    using namespace std;
+
+    /** Open list implemented as a binary heap without index by node id.
+        Decreasing the key of a node is done by inserting a new entry, the
+        outdated entry is skipped by the search when it is popped.
+        Ties are broken in favor of larger g values and then in favor of
+        the entry that was inserted first, like AStar::OpenListBase.
+    */
+    class BasicOpenHeap
+    {
+    public:
+        BasicOpenHeap()
+            : m_nextSequence(0)
+        {
+        }
+
+        /** Initialize for search. */
+        void init()
+        {
+            m_heap.clear();
+            m_nextSequence = 0;
+        }
+
+        void insert(int nodeId, int g, int f)
+        {
+            Entry entry;
+            entry.m_f = f;
+            entry.m_g = g;
+            entry.m_sequence = m_nextSequence++;
+            entry.m_nodeId = nodeId;
+            m_heap.push_back(entry);
+            push_heap(m_heap.begin(), m_heap.end(), Compare());
+        }
+
+        bool isEmpty() const
+        {
+            return m_heap.empty();
+        }
+
+        /** Get the entry with lowest f value without removing it. */
+        void top(int& nodeId, int& g, int& f) const
+        {
+            assert(! isEmpty());
+            const Entry& entry = m_heap.front();
+            nodeId = entry.m_nodeId;
+            g = entry.m_g;
+            f = entry.m_f;
+        }
+
+        /** Remove the entry with lowest f value. */
+        void pop(int& nodeId, int& g, int& f)
+        {
+            assert(! isEmpty());
+            pop_heap(m_heap.begin(), m_heap.end(), Compare());
+            const Entry& entry = m_heap.back();
+            nodeId = entry.m_nodeId;
+            g = entry.m_g;
+            f = entry.m_f;
+            m_heap.pop_back();
+        }
+
+    private:
+        class Entry
+        {
+        public:
+            int m_f;
+
+            int m_g;
+
+            int m_sequence;
+
+            int m_nodeId;
+        };
+
+        /** Order for std::push_heap, which keeps the largest entry on top.
+            An entry is smaller if it is worse.
+        */
+        class Compare
+        {
+        public:
+            bool operator()(const Entry& entry1, const Entry& entry2) const
+            {
+                if (entry1.m_f != entry2.m_f)
+                    return (entry1.m_f > entry2.m_f);
+                if (entry1.m_g != entry2.m_g)
+                    return (entry1.m_g < entry2.m_g);
+                return (entry1.m_sequence > entry2.m_sequence);
+            }
+        };
+
+        int m_nextSequence;
+
+        vector<Entry> m_heap;
+    };
+
+    /** Environment for BasicAStar using the member functions of a
+        subclass of Environment.
+        The functions of ENV are called non-virtually, so ENV must be the
+        class of the actual environment object.
+    */
+    template<class ENV>
+    class EnvironmentAdapter
+    {
+    public:
+        /** Uses the heuristic of the environment. */
+        class Heuristic
+        {
+        public:
+            int operator()(const EnvironmentAdapter& env, int nodeId,
+                           int target) const
+            {
+                return env.getHeuristic(nodeId, target);
+            }
+        };
+
+        explicit EnvironmentAdapter(const ENV& env)
+            : m_env(env)
+        {
+        }
+
+        int getHeuristic(int nodeId, int target) const
+        {
+            return m_env.ENV::getHeuristic(nodeId, target);
+        }
+
+        int getNumberNodes() const
+        {
+            return m_env.ENV::getNumberNodes();
+        }
+
+        template<class VISITOR>
+        void visitSuccessors(int nodeId, VISITOR& visitor) const
+        {
+            VisitorAdapter<VISITOR> adapter(visitor);
+            m_env.ENV::visitSuccessors(nodeId, NO_NODE, adapter);
+        }
+
+    private:
+        /** Passes the successors of the environment to a visitor of
+            BasicAStar.
+        */
+        template<class VISITOR>
+        class VisitorAdapter
+            : public Environment::SuccessorVisitor
+        {
+        public:
+            explicit VisitorAdapter(VISITOR& visitor)
+                : m_visitor(visitor)
+            {
+            }
+
+            bool visit(int target, int cost)
+            {
+                return m_visitor.visit(target, cost);
+            }
+
+        private:
+            VISITOR& m_visitor;
+        };
+
+        const ENV& m_env;
+    };
+
+    /** A* search engine with statically bound environment type.
+        Expands nodes in the same order as AStar, so it finds the same
+        paths. Keeps per-node arrays between searches like
+        AStar::CLOSED_NODE_STATES.
+        Counts expanded and visited nodes and samples the same per
+        expansion statistics as AStar, if SAMPLE_EXPANSIONS is true. The
+        collection of the statistics is left to the caller.
+    */
+    template<class ENV, class HEURISTIC = typename ENV::Heuristic,
+             class OPEN = BasicOpenHeap>
+    class BasicAStar
+    {
+    public:
+        BasicAStar()
+            : m_isAborted(false),
+              m_tracing(false),
+              m_pathCost(-1),
+              m_nodesLimit(-1),
+              m_nodesExpanded(0),
+              m_nodesVisited(0),
+              m_openSize(0)
+        {
+        }
+
+        /** Find a path.
+            @return Cost of the path found, -1 if no path exists or the
+            search was aborted due to the node limit.
+        */
+        int findPath(const ENV& env, int start, int target);
+
+        /** Number of successors of each expanded node in last search. */
+        const Statistics& getBranchingFactor() const
+        {
+            return m_branchingFactor;
+        }
+
+        long long int getNodesExpanded() const
+        {
+            return m_nodesExpanded;
+        }
+
+        long long int getNodesVisited() const
+        {
+            return m_nodesVisited;
+        }
+
+        /** Number of open nodes before each expansion in last search. */
+        const Statistics& getOpenLength() const
+        {
+            return m_openLength;
+        }
+
+        /** Maximum number of open nodes in last search.
+            Like in AStar, only sampled if the target was not found.
+        */
+        const Statistics& getOpenMax() const
+        {
+            return m_openMax;
+        }
+
+        /** Get path of last search, from target to start. */
+        const vector<int>& getPath() const
+        {
+            return m_path;
+        }
+
+        int getPathCost() const
+        {
+            return m_pathCost;
+        }
+
+        /** Get ids of nodes visited in last search, if tracing. */
+        const vector<int>& getVisitedNodeIds() const
+        {
+            return m_visitedNodeIds;
+        }
+
+        /** Check if last search was aborted due to the node limit. */
+        bool isAborted() const
+        {
+            return m_isAborted;
+        }
+
+        /** Set nodes limit.
+            Like Search::setNodesLimit, -1 means unlimited search.
+        */
+        void setNodesLimit(long long int nodesLimit)
+        {
+            m_nodesLimit = nodesLimit;
+        }
+
+        /** Enable recording of visited node ids. */
+        void setTracing(bool enable)
+        {
+            m_tracing = enable;
+        }
+
+    private:
+        class Relaxer;
+
+        friend class Relaxer;
+
+        /** Visitor that relaxes the successors of an expanded node. */
+        class Relaxer
+        {
+        public:
+            Relaxer(BasicAStar& search, const ENV& env, int nodeId, int g,
+                    int target)
+                : m_search(search),
+                  m_env(env),
+                  m_nodeId(nodeId),
+                  m_g(g),
+                  m_target(target),
+                  m_numberSuccessors(0)
+            {
+            }
+
+            int getNumberSuccessors() const
+            {
+                return m_numberSuccessors;
+            }
+
+            bool visit(int successor, int cost)
+            {
+                ++m_numberSuccessors;
+                m_search.relax(m_env, m_nodeId, m_g, successor, cost,
+                               m_target);
+                return true;
+            }
+
+        private:
+            BasicAStar& m_search;
+
+            const ENV& m_env;
+
+            int m_nodeId;
+
+            int m_g;
+
+            int m_target;
+
+            int m_numberSuccessors;
+        };
+
+        bool m_isAborted;
+
+        bool m_tracing;
+
+        int m_pathCost;
+
+        long long int m_nodesLimit;
+
+        long long int m_nodesExpanded;
+
+        long long int m_nodesVisited;
+
+        /** Number of nodes in state OPEN. */
+        int m_openSize;
+
+        HEURISTIC m_heuristic;
+
+        NodeStateArray m_nodeStates;
+
+        OPEN m_open;
+
+        vector<int> m_path;
+
+        vector<int> m_visitedNodeIds;
+
+        Statistics m_branchingFactor;
+
+        Statistics m_openLength;
+
+        Statistics m_openMax;
+
+        void relax(const ENV& env, int nodeId, int g, int successor,
+                   int cost, int target)
+        {
+            int newg = g + cost;
+            NodeStateArray::State state = m_nodeStates.getState(successor);
+            if (state != NodeStateArray::UNSEEN
+                && newg >= m_nodeStates.getG(successor))
+                return;
+            m_nodeStates.setOpen(successor, newg, nodeId);
+            if (state != NodeStateArray::OPEN)
+                ++m_openSize;
+            m_open.insert(successor, newg,
+                          newg + m_heuristic(env, successor, target));
+        }
+    };
+
+    template<class ENV, class HEURISTIC, class OPEN>
+    int BasicAStar<ENV, HEURISTIC, OPEN>::findPath(const ENV& env, int start,
+                                                    int target)
+    {
+        m_isAborted = false;
+        m_pathCost = -1;
+        m_nodesExpanded = 0;
+        m_nodesVisited = 0;
+        m_path.clear();
+        m_visitedNodeIds.clear();
+        m_branchingFactor.clear();
+        m_openLength.clear();
+        m_openMax.clear();
+        NodeStateArray& nodeStates = m_nodeStates;
+        nodeStates.init(env.getNumberNodes());
+        m_open.init();
+        nodeStates.setOpen(start, 0, NO_NODE);
+        m_open.insert(start, 0, m_heuristic(env, start, target));
+        m_openSize = 1;
+        int maxOpenSize = 0;
+        while (! m_open.isEmpty())
+        {
+            int nodeId;
+            int g;
+            int f;
+            m_open.pop(nodeId, g, f);
+            if (nodeStates.getState(nodeId) != NodeStateArray::OPEN
+                || nodeStates.getG(nodeId) != g)
+                continue; // outdated entry
+            if (SAMPLE_EXPANSIONS)
+            {
+                m_openLength.add(m_openSize);
+                if (m_openSize > maxOpenSize)
+                    maxOpenSize = m_openSize;
+            }
+            --m_openSize;
+            ++m_nodesVisited;
+            if (m_tracing)
+                m_visitedNodeIds.push_back(nodeId);
+            nodeStates.setClosed(nodeId);
+            if (nodeId == target)
+            {
+                m_path = nodeStates.constructPath(start, target);
+                m_pathCost = g;
+                return m_pathCost;
+            }
+            if (m_nodesLimit >= 0 && m_nodesVisited > m_nodesLimit)
+            {
+                m_isAborted = true;
+                break;
+            }
+            ++m_nodesExpanded;
+            Relaxer relaxer(*this, env, nodeId, g, target);
+            env.visitSuccessors(nodeId, relaxer);
+            if (SAMPLE_EXPANSIONS)
+                m_branchingFactor.add(relaxer.getNumberSuccessors());
+        }
+        if (SAMPLE_EXPANSIONS)
+            m_openMax.add(maxOpenSize);
+        return m_pathCost;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,251 @@
+//-----------------------------------------------------------------------------
+/** @file benchmark.cpp
+    Benchmark comparing search engine variants on random tilings.
+
+    Usage: pfbench type rows columns obstacle_percentage number_runs
+    [number_threads]
+
+    Type is one of tile, octile, octile_unicost.
+    All engines solve the same random start/target pairs on the same
+    tiling. For each engine the total CPU time and the mean number of
+    nodes expanded and path cost are printed.
+    The groups compare the open lists, the closed lists, the
+    templated A* with the virtual one, bidirectional A* with A*,
+    for octile tilings jump point search with A*, fringe search and
+    IDA* with A*, the suboptimal A* modes and ARA* with and without a
+    node limit.
+    Finally the pre-processing of a two-level abstraction is run with
+    one thread and with number_threads threads (default number of
+    processors). It prints the wall-clock time, the CPU time of the
+    process and the size of the abstract graph, which must not depend
+    on the number of threads.
+*/
+//-----------------------------------------------------------------------------
+
+#include <memory>
+#include <stdlib.h>
+#include <iomanip>
+#include <sys/time.h>
+#include <time.h>
+#include "pathfind.h"
+#include "abswizard.h"
+#include "tilingastar.h"
+
+using namespace std;
+using namespace PathFind;
+
+//-----------------------------------------------------------------------------
+
+typedef vector<pair<int, int> > Queries;
+
+//-----------------------------------------------------------------------------
+
+static void runBenchmark(const string& name, Search& search,
+                         const Tiling& tiling, const Queries& queries)
+{
+    StatisticsCollection statistics = search.createStatistics();
+    for (Queries::const_iterator i = queries.begin(); i != queries.end(); ++i)
+    {
+        search.findPath(tiling, i->first, i->second);
+        statistics.add(search.getStatistics());
+    }
+    cout << setw(20) << left << name << right
+         << setw(12) << statistics.get("cpu_time").getMean() * queries.size()
+         << setw(16) << statistics.get("nodes_expanded").getMean()
+         << setw(12) << statistics.get("path_cost").getMean() << '\n';
+}
+
+static void runOpenListBenchmark(const Tiling& tiling, const Queries& queries)
+{
+    AStar multiset(true, AStar::OPEN_MULTISET);
+    runBenchmark("astar_multiset", multiset, tiling, queries);
+    AStar binaryHeap(true, AStar::OPEN_BINARY_HEAP);
+    runBenchmark("astar_binary_heap", binaryHeap, tiling, queries);
+    AStar pairingHeap(true, AStar::OPEN_PAIRING_HEAP);
+    runBenchmark("astar_pairing_heap", pairingHeap, tiling, queries);
+    AStar buckets(true, AStar::OPEN_BUCKETS);
+    runBenchmark("astar_buckets", buckets, tiling, queries);
+}
+
+static void runClosedListBenchmark(const Tiling& tiling,
+                                   const Queries& queries)
+{
+    AStar perfectHash(AStar::CLOSED_PERFECT_HASH, AStar::OPEN_BINARY_HEAP);
+    runBenchmark("closed_perfect_hash", perfectHash, tiling, queries);
+    AStar nodeStates(AStar::CLOSED_NODE_STATES, AStar::OPEN_BINARY_HEAP);
+    runBenchmark("closed_node_states", nodeStates, tiling, queries);
+    AStar sparseHash(AStar::CLOSED_SPARSE_HASH);
+    runBenchmark("closed_sparse_hash", sparseHash, tiling, queries);
+}
+
+static void runTemplateBenchmark(const Tiling& tiling, const Queries& queries)
+{
+    AStar virtualCalls(AStar::CLOSED_NODE_STATES, AStar::OPEN_BINARY_HEAP);
+    runBenchmark("astar_virtual", virtualCalls, tiling, queries);
+    TilingAStar templateSearch;
+    runBenchmark("astar_template", templateSearch, tiling, queries);
+}
+
+static void runBidirectionalBenchmark(const Tiling& tiling,
+                                      const Queries& queries)
+{
+    AStar unidirectional(AStar::CLOSED_NODE_STATES, AStar::OPEN_BINARY_HEAP);
+    runBenchmark("astar", unidirectional, tiling, queries);
+    BidirectionalAStar bidirectional;
+    runBenchmark("astar_bidirectional", bidirectional, tiling, queries);
+}
+
+static void runJumpPointBenchmark(const Tiling& tiling,
+                                  const Queries& queries)
+{
+    if (! JumpPointSearch::isSupported(tiling))
+        return;
+    AStar astar(AStar::CLOSED_NODE_STATES, AStar::OPEN_BINARY_HEAP);
+    runBenchmark("astar", astar, tiling, queries);
+    JumpPointSearch jumpPointSearch;
+    runBenchmark("jump_point_search", jumpPointSearch, tiling, queries);
+}
+
+static void runThresholdBenchmark(const Tiling& tiling,
+                                  const Queries& queries)
+{
+    AStar astar(AStar::CLOSED_NODE_STATES, AStar::OPEN_BINARY_HEAP);
+    runBenchmark("astar", astar, tiling, queries);
+    FringeSearch fringeSearch;
+    runBenchmark("fringe_search", fringeSearch, tiling, queries);
+    // Without transposition table IDA* is too slow on larger tilings
+    IDAStar idaStar;
+    runBenchmark("ida_star", idaStar, tiling, queries);
+}
+
+static void runSuboptimalBenchmark(const Tiling& tiling,
+                                   const Queries& queries)
+{
+    AStar weighted(AStar::CLOSED_NODE_STATES, AStar::OPEN_BINARY_HEAP);
+    weighted.setSuboptimalityBound(1.5, AStar::SUBOPTIMAL_WEIGHTED);
+    runBenchmark("weighted_1.5", weighted, tiling, queries);
+    AStar focal(AStar::CLOSED_NODE_STATES, AStar::OPEN_BINARY_HEAP);
+    focal.setSuboptimalityBound(1.5, AStar::SUBOPTIMAL_FOCAL);
+    runBenchmark("focal_1.5", focal, tiling, queries);
+}
+
+static void runAnytimeBenchmark(const Tiling& tiling, const Queries& queries)
+{
+    ARAStar araStar;
+    runBenchmark("ara_star", araStar, tiling, queries);
+    ARAStar limited;
+    limited.setNodesLimit(1000);
+    runBenchmark("ara_star_1000", limited, tiling, queries);
+}
+
+static double getWallTime()
+{
+    timeval time;
+    gettimeofday(&time, 0);
+    return time.tv_sec + time.tv_usec / 1e6;
+}
+
+static void runPreprocessing(const Tiling& tiling, int numberThreads)
+{
+    AbsWizard wizard(tiling, 10, 2, AbsWizard::END_ENTRANCE);
+    HTiling& absTiling = wizard.getAbsTiling();
+    absTiling.setNumberThreads(numberThreads);
+    double wallTime = getWallTime();
+    clock_t startTime = clock();
+    wizard.abstractMaze();
+    double cpuTime =
+        static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
+    wallTime = getWallTime() - wallTime;
+    int edges = 0;
+    for (int level = 1; level <= 2; ++level)
+    {
+        StatisticsCollection storage = absTiling.getStorageStatistics(level);
+        edges += static_cast<int>(storage.get("inter_edges").getCount()
+                                  + storage.get("intra_edges").getCount());
+    }
+    cout << setw(20) << left << numberThreads << right
+         << setw(12) << wallTime << setw(12) << cpuTime
+         << setw(16) << absTiling.getNumberNodes()
+         << setw(12) << edges << '\n';
+}
+
+static void runPreprocessingBenchmark(const Tiling& tiling,
+                                      int numberThreads)
+{
+    cout << setw(20) << left << "threads" << right
+         << setw(12) << "wall_time" << setw(12) << "cpu_time"
+         << setw(16) << "abs_nodes" << setw(12) << "abs_edges" << '\n';
+    runPreprocessing(tiling, 1);
+    if (numberThreads > 1)
+        runPreprocessing(tiling, numberThreads);
+}
+
+static Tiling::Type getType(const string& typeString)
+{
+    if (typeString == "tile")
+        return Tiling::TILE;
+    if (typeString == "octile")
+        return Tiling::OCTILE;
+    if (typeString == "octile_unicost")
+        return Tiling::OCTILE_UNICOST;
+    throw Error("Invalid type value.");
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    if (argc != 6 && argc != 7)
+    {
+        cerr << "Usage: " << argv[0]
+             << " type rows columns obstacle_percentage number_runs"
+             << " [number_threads]\n";
+        return -1;
+    }
+    try
+    {
+        Tiling::Type type = getType(argv[1]);
+        int rows = atoi(argv[2]);
+        int columns = atoi(argv[3]);
+        float obstaclePercentage = atof(argv[4]);
+        int numberRuns = atoi(argv[5]);
+        int numberThreads = (argc == 7 ? atoi(argv[6])
+                             : ThreadPool::getNumberProcessors());
+        cerr << "Create tiling...\n";
+        Tiling tiling(type, rows, columns);
+        tiling.setObstacles(obstaclePercentage);
+        cerr << "Find start/target pairs...\n";
+        SearchUtils searchUtils;
+        Queries queries;
+        for (int i = 0; i < numberRuns; ++i)
+        {
+            int start, target;
+            searchUtils.findRandomStartTarget(tiling, start, target);
+            queries.push_back(make_pair(start, target));
+        }
+        cout << "Type: " << argv[1] << "; Rows: " << rows
+             << "; Columns: " << columns
+             << "; Obstacle%: " << obstaclePercentage
+             << "; Number of runs: " << numberRuns << '\n';
+        cout << setw(20) << left << "engine" << right
+             << setw(12) << "cpu_time" << setw(16) << "nodes_expanded"
+             << setw(12) << "path_cost" << '\n';
+        runOpenListBenchmark(tiling, queries);
+        runClosedListBenchmark(tiling, queries);
+        runTemplateBenchmark(tiling, queries);
+        runBidirectionalBenchmark(tiling, queries);
+        runJumpPointBenchmark(tiling, queries);
+        runThresholdBenchmark(tiling, queries);
+        runSuboptimalBenchmark(tiling, queries);
+        runAnytimeBenchmark(tiling, queries);
+        runPreprocessingBenchmark(tiling, numberThreads);
+    }
+    catch (const exception& e)
+    {
+        cerr << "Error: " << e.what() << '\n';
+        return -1;
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
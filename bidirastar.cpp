@@ -0,0 +1,266 @@
+//-----------------------------------------------------------------------------
+/** @file bidirastar.cpp
+    @see bidirastar.h
+*/
+//-----------------------------------------------------------------------------
+
+#include "bidirastar.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+using namespace std;
+using namespace PathFind;
+
+//-----------------------------------------------------------------------------
+
+BidirectionalAStar::Frontier::Frontier()
+    : m_goal(NO_NODE),
+      m_openSize(0)
+{
+}
+
+bool BidirectionalAStar::Frontier::discardOutdated()
+{
+    while (! m_open.isEmpty())
+    {
+        int nodeId;
+        int g;
+        int f;
+        m_open.top(nodeId, g, f);
+        if (m_nodeStates.getState(nodeId) == NodeStateArray::OPEN
+            && m_nodeStates.getG(nodeId) == g)
+            return true;
+        m_open.pop(nodeId, g, f);
+    }
+    return false;
+}
+
+int BidirectionalAStar::Frontier::getMinF() const
+{
+    int nodeId;
+    int g;
+    int f;
+    m_open.top(nodeId, g, f);
+    return f;
+}
+
+void BidirectionalAStar::Frontier::init(int numberNodes, int root, int goal,
+                                        int heuristic)
+{
+    m_goal = goal;
+    m_nodeStates.init(numberNodes);
+    m_open.init();
+    m_nodeStates.setOpen(root, 0, NO_NODE);
+    m_open.insert(root, 0, heuristic);
+    m_openSize = 1;
+}
+
+//-----------------------------------------------------------------------------
+
+BidirectionalAStar::Relaxer::Relaxer(BidirectionalAStar& search,
+                                     Frontier& frontier,
+                                     const Frontier& other, int nodeId,
+                                     int g)
+    : m_search(search),
+      m_frontier(frontier),
+      m_other(other),
+      m_nodeId(nodeId),
+      m_g(g),
+      m_numberSuccessors(0)
+{
+}
+
+bool BidirectionalAStar::Relaxer::visit(int target, int cost)
+{
+    ++m_numberSuccessors;
+    m_search.relax(m_frontier, m_other, m_nodeId, m_g, target, cost);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+BidirectionalAStar::BidirectionalAStar()
+    : m_isAborted(false),
+      m_bestCost(INT_MAX),
+      m_meetingNode(NO_NODE),
+      m_pathCost(-1),
+      m_env(0),
+      m_nodesExpanded(0),
+      m_nodesVisited(0),
+      m_numberNodes(0),
+      m_statistics(createStatistics()),
+      m_branchingFactor(m_statistics.get("branching_factor")),
+      m_cpuTimeStatistics(m_statistics.get("cpu_time")),
+      m_nodesExpandedStatistics(m_statistics.get("nodes_expanded")),
+      m_nodesVisitedStatistics(m_statistics.get("nodes_visited")),
+      m_openLengthStatistics(m_statistics.get("open_length")),
+      m_openMaxStatistics(m_statistics.get("open_max")),
+      m_pathCostStatistics(m_statistics.get("path_cost")),
+      m_pathLengthStatistics(m_statistics.get("path_length"))
+{
+}
+
+StatisticsCollection BidirectionalAStar::createStatistics()
+{
+    return createBasicStatistics();
+}
+
+void BidirectionalAStar::constructPath(int start, int target)
+{
+    // Path is stored from target to start like in AStar
+    vector<int> backwardPath =
+        m_backward.m_nodeStates.constructPath(target, m_meetingNode);
+    m_path.assign(backwardPath.rbegin(), backwardPath.rend());
+    vector<int> forwardPath =
+        m_forward.m_nodeStates.constructPath(start, m_meetingNode);
+    m_path.insert(m_path.end(), forwardPath.begin() + 1, forwardPath.end());
+}
+
+void BidirectionalAStar::expand(Frontier& frontier, const Frontier& other)
+{
+    int nodeId;
+    int g;
+    int f;
+    frontier.m_open.pop(nodeId, g, f);
+    frontier.m_nodeStates.setClosed(nodeId);
+    --frontier.m_openSize;
+    ++m_nodesVisited;
+    traceVisited(nodeId);
+    // Paths through nodes closed by the other search are already known,
+    // if the heuristic is consistent
+    if (other.m_nodeStates.getState(nodeId) == NodeStateArray::CLOSED)
+        return;
+    ++m_nodesExpanded;
+    Relaxer relaxer(*this, frontier, other, nodeId, g);
+    m_env->visitSuccessors(nodeId, NO_NODE, relaxer);
+    if (SAMPLE_EXPANSIONS)
+        m_branchingFactor.add(relaxer.getNumberSuccessors());
+}
+
+bool BidirectionalAStar::findPath(const Environment& env, int start,
+                                  int target)
+{
+    assert(env.isValidNodeId(start));
+    assert(env.isValidNodeId(target));
+    clock_t startTime = clock();
+    m_statistics.clear();
+    m_nodesExpanded = 0;
+    m_nodesVisited = 0;
+    m_env = &env;
+    m_numberNodes = env.getNumberNodes();
+    clearTrace();
+    m_path.clear();
+    m_pathCost = -1;
+    m_isAborted = false;
+    findPathBidirectional(start, target);
+    double timeDiff =
+        static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
+    m_cpuTimeStatistics.add(timeDiff);
+    m_nodesExpandedStatistics.add(m_nodesExpanded);
+    m_nodesVisitedStatistics.add(m_nodesVisited);
+    m_pathLengthStatistics.add(m_path.size());
+    return ! m_isAborted;
+}
+
+void BidirectionalAStar::findPathBidirectional(int start, int target)
+{
+    int maxopen = 0;
+    m_forward.init(m_numberNodes, start, target,
+                   m_env->getHeuristic(start, target));
+    m_backward.init(m_numberNodes, target, start,
+                    m_env->getHeuristic(target, start));
+    m_bestCost = INT_MAX;
+    m_meetingNode = NO_NODE;
+    if (start == target)
+    {
+        m_bestCost = 0;
+        m_meetingNode = start;
+    }
+    while (m_forward.discardOutdated() && m_backward.discardOutdated())
+    {
+        if (m_bestCost <= max(m_forward.getMinF(), m_backward.getMinF()))
+            break;
+        if (SAMPLE_EXPANSIONS)
+        {
+            int openSize = m_forward.m_openSize + m_backward.m_openSize;
+            m_openLengthStatistics.add(openSize);
+            if (openSize > maxopen)
+                maxopen = openSize;
+        }
+        // Expand the smaller frontier
+        if (m_forward.m_openSize <= m_backward.m_openSize)
+            expand(m_forward, m_backward);
+        else
+            expand(m_backward, m_forward);
+        if (m_nodesLimit >= 0 && m_nodesVisited > m_nodesLimit)
+        {
+            m_isAborted = true;
+            break;
+        }
+    }
+    if (SAMPLE_EXPANSIONS)
+        m_openMaxStatistics.add(maxopen);
+    if (m_isAborted || m_meetingNode == NO_NODE)
+        return;
+    constructPath(start, target);
+    m_pathCost = m_bestCost;
+    m_pathCostStatistics.add(m_pathCost);
+}
+
+const StatisticsCollection& BidirectionalAStar::getStatistics() const
+{
+    return m_statistics;
+}
+
+const vector<char>& BidirectionalAStar::getVisitedNodes() const
+{
+    m_visitedNodes.assign(m_numberNodes, ' ');
+    const vector<int>& visitedNodeIds = getVisitedNodeIds();
+    for (vector<int>::const_iterator i = visitedNodeIds.begin();
+         i != visitedNodeIds.end(); ++i)
+    {
+        bool isForward = (m_forward.m_nodeStates.getState(*i)
+                          == NodeStateArray::CLOSED);
+        bool isBackward = (m_backward.m_nodeStates.getState(*i)
+                           == NodeStateArray::CLOSED);
+        if (isForward && ! isBackward)
+            m_visitedNodes[*i] = 'f';
+        else if (isBackward && ! isForward)
+            m_visitedNodes[*i] = 'b';
+        else
+            m_visitedNodes[*i] = '+';
+    }
+    return m_visitedNodes;
+}
+
+void BidirectionalAStar::relax(Frontier& frontier, const Frontier& other,
+                               int nodeId, int g, int target, int cost)
+{
+    int newg = g + cost;
+    NodeStateArray& nodeStates = frontier.m_nodeStates;
+    NodeStateArray::State state = nodeStates.getState(target);
+    if (state != NodeStateArray::UNSEEN && newg >= nodeStates.getG(target))
+        return;
+    int newHeuristic = m_env->getHeuristic(target, frontier.m_goal);
+    // Nodes that cannot be on a better path than the best path found
+    // are not added to the open list
+    if (newg + newHeuristic >= m_bestCost)
+        return;
+    nodeStates.setOpen(target, newg, nodeId);
+    if (state != NodeStateArray::OPEN)
+        ++frontier.m_openSize;
+    frontier.m_open.insert(target, newg, newg + newHeuristic);
+    if (other.m_nodeStates.getState(target) == NodeStateArray::UNSEEN)
+        return;
+    int pathCost = newg + other.m_nodeStates.getG(target);
+    if (pathCost < m_bestCost)
+    {
+        m_bestCost = pathCost;
+        m_meetingNode = target;
+    }
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,201 @@
+//-----------------------------------------------------------------------------
+/** @file bidirastar.h
+    Bidirectional A* search.
+
+    Short description of bidirectional A*:
+
+    Two A* searches run alternately, one from the start towards the
+    target and one from the target towards the start. Each search uses
+    the heuristic to its own goal (front-to-end). Whenever a node is
+    reached that the other search has already reached, the cost of the
+    connecting path is compared with the best path found so far.
+    The search stops as soon as the best path found is not more
+    expensive than the lowest f value in one of the open lists, because
+    every path that is still unknown has to pass an open node of both
+    searches. Nodes that cannot be on a path better than the best path
+    found are not added to the open lists, and nodes already closed by
+    the other search are not expanded again.
+*/
+//-----------------------------------------------------------------------------
+
+#ifndef PATHFIND_BIDIRASTAR_H
+#define PATHFIND_BIDIRASTAR_H
+
+#include "basicastar.h"
+#include "nodestatearray.h"
+#include "search.h"
+
+//-----------------------------------------------------------------------------
+
+namespace PathFind
+{
+    using namespace std;
+
+    /** Bidirectional A* search engine.
+        The backward search follows the edges returned by
+        Environment::visitSuccessors() in reverse direction, so the
+        environment must have a reverse edge with the same cost for each
+        edge. The heuristic must be consistent in both directions, because
+        nodes closed by the other search are not expanded, and the search
+        stops when the best path is not more expensive than the larger of
+        the lowest f values of the two searches. With a heuristic that is
+        only admissible, these rules can miss the optimal path.
+        Both conditions hold for Tiling and the abstract graph of
+        AbsTiling.
+        Collects the same statistics as AStar, so it can replace AStar
+        where the statistics of searches are accumulated.
+    */
+    class BidirectionalAStar
+        : public Search
+    {
+    public:
+        BidirectionalAStar();
+
+        StatisticsCollection createStatistics();
+
+        /** Find a path.
+            @return false, if search was aborted due to node limit.
+        */
+        bool findPath(const Environment& env, int start, int target);
+
+        const vector<int>& getPath() const
+        {
+            return m_path;
+        }
+
+        int getPathCost() const
+        {
+            return m_pathCost;
+        }
+
+        const StatisticsCollection& getStatistics() const;
+
+        /** Get a vector with char labels for each visited node.
+            The label is 'f' for nodes visited by the forward search,
+            'b' for the backward search and '+' for both.
+            @see Search::getVisitedNodes
+        */
+        const vector<char>& getVisitedNodes() const;
+
+    private:
+        /** Search in one direction. */
+        class Frontier
+        {
+        public:
+            Frontier();
+
+            /** Goal of the heuristic in this direction. */
+            int m_goal;
+
+            /** Number of nodes in state OPEN. */
+            int m_openSize;
+
+            NodeStateArray m_nodeStates;
+
+            BasicOpenHeap m_open;
+
+            /** Remove outdated entries from the top of the open list.
+                @return false, if the open list is empty.
+            */
+            bool discardOutdated();
+
+            /** Lowest f value in open list.
+                Only valid after discardOutdated() returned true.
+            */
+            int getMinF() const;
+
+            void init(int numberNodes, int root, int goal, int heuristic);
+        };
+
+        class Relaxer;
+
+        friend class Relaxer;
+
+        /** Visitor that relaxes the successors of an expanded node. */
+        class Relaxer
+            : public Environment::SuccessorVisitor
+        {
+        public:
+            Relaxer(BidirectionalAStar& search, Frontier& frontier,
+                    const Frontier& other, int nodeId, int g);
+
+            int getNumberSuccessors() const
+            {
+                return m_numberSuccessors;
+            }
+
+            bool visit(int target, int cost);
+
+        private:
+            BidirectionalAStar& m_search;
+
+            Frontier& m_frontier;
+
+            const Frontier& m_other;
+
+            int m_nodeId;
+
+            int m_g;
+
+            int m_numberSuccessors;
+        };
+
+        bool m_isAborted;
+
+        /** Cost of the best path found so far. */
+        int m_bestCost;
+
+        /** Node connecting the searches on the best path found so far. */
+        int m_meetingNode;
+
+        int m_pathCost;
+
+        const Environment* m_env;
+
+        long long int m_nodesExpanded;
+
+        long long int m_nodesVisited;
+
+        /** Number of nodes of the environment in the last search. */
+        int m_numberNodes;
+
+        Frontier m_forward;
+
+        Frontier m_backward;
+
+        vector<int> m_path;
+
+        mutable vector<char> m_visitedNodes;
+
+        StatisticsCollection m_statistics;
+
+        Statistics& m_branchingFactor;
+
+        Statistics& m_cpuTimeStatistics;
+
+        Statistics& m_nodesExpandedStatistics;
+
+        Statistics& m_nodesVisitedStatistics;
+
+        Statistics& m_openLengthStatistics;
+
+        Statistics& m_openMaxStatistics;
+
+        Statistics& m_pathCostStatistics;
+
+        Statistics& m_pathLengthStatistics;
+
+        void constructPath(int start, int target);
+
+        void expand(Frontier& frontier, const Frontier& other);
+
+        void findPathBidirectional(int start, int target);
+
+        void relax(Frontier& frontier, const Frontier& other, int nodeId,
+                   int g, int target, int cost);
+    };
+}
+
+//-----------------------------------------------------------------------------
+
+#endif
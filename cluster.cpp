@@ -16,6 +16,27 @@ using namespace PathFind;
 
 //-----------------------------------------------------------------------------
 
+namespace
+{
+    /** Run a search in a cluster with AStar or JumpPointSearch.
+        @param nodesLimit Node limit or -1 for unlimited search.
+        @param statistics Collection the statistics of the search are
+        added to, or 0.
+    */
+    template<class SEARCH>
+    void runSearch(SEARCH& search, const TilingWindow& window, int start,
+                   int target, long long int nodesLimit,
+                   StatisticsCollection* statistics)
+    {
+        search.setNodesLimit(nodesLimit);
+        search.findPath(window, target, start);
+        if (statistics != 0)
+            statistics->add(search.getStatistics());
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 Entrance::Entrance()
 {}
 
@@ -45,7 +66,7 @@ Entrance::~Entrance()
 Cluster::Cluster(const Tiling &tiling, int id, 
                  int row, int col,
                  int horizOrigin, int vertOrigin, int width, int height)
-    : m_tiling(tiling, horizOrigin, vertOrigin, width, height),
+    : m_window(tiling, horizOrigin, vertOrigin, width, height),
       m_id(id),
       m_row(row),
       m_column(col),
@@ -130,7 +151,8 @@ int Cluster::getLocalCenter(int localIdx) const
     return entrance.getCenterRow()*m_width + entrance.getCenterCol();
 }
 
-void Cluster::computePaths(StatisticsCollection &statistics)
+void Cluster::computePaths(StatisticsCollection &statistics,
+                           SearchPool& searchPool)
 {
     for (int i = 0; i < MAX_CLENTRANCES; i++)
         for (int j = 0; j < MAX_CLENTRANCES; j++)
@@ -139,14 +161,10 @@ void Cluster::computePaths(StatisticsCollection &statistics)
         }
     for (vector<LocalEntrance>::const_iterator i = m_entrances.begin();
          i != m_entrances.end(); ++i)
-    for (vector<LocalEntrance>::const_iterator j = m_entrances.begin();
-         j != m_entrances.end(); ++j)
      {
          assert (i->getEntranceLocalIdx() >= 0);
-         assert (j->getEntranceLocalIdx() >= 0);
          assert (i->getEntranceLocalIdx() < MAX_CLENTRANCES);
-         assert (j->getEntranceLocalIdx() < MAX_CLENTRANCES);
-         computeAddPath(*i, *j, statistics);
+         computeEntrancePaths(*i, statistics, searchPool);
      }
 }
 
@@ -161,56 +179,63 @@ void Cluster::removeLastEntranceRecord()
     }
 }
 
-void Cluster::updatePaths(int entranceId, StatisticsCollection &statistics)
+void Cluster::updatePaths(int entranceId, StatisticsCollection &statistics,
+                          SearchPool& searchPool)
 {
-    const LocalEntrance& entrance = m_entrances[entranceId];
-    for (vector<LocalEntrance>::const_iterator j = m_entrances.begin();
-         j != m_entrances.end(); ++j)
-     {
-         computeAddPath(entrance, *j, statistics);
-     }
+    computeEntrancePaths(m_entrances[entranceId], statistics, searchPool);
 }
 
-void Cluster::computeAddPath(const LocalEntrance& e1, const LocalEntrance& e2, 
-                             StatisticsCollection &statistics)
+void Cluster::computeEntrancePaths(const LocalEntrance& entrance,
+                                   StatisticsCollection &statistics,
+                                   SearchPool& searchPool)
 {
-    int start = getEntranceCenter(e1);
-    int target = getEntranceCenter(e2);
-    int startIdx = e1.getEntranceLocalIdx();
-    int targetIdx = e2.getEntranceLocalIdx();
-
-    if (m_boolPathMap[startIdx][targetIdx])
-        return;
-    if (startIdx == targetIdx)
-        return;
-    assert(start != target);
-//     if (start == target)
-//     {
-//         m_distances[startIdx][targetIdx] = 0;
-//         m_distances[targetIdx][startIdx] = 0;
-//     } else
-    if (checkPathExists(start, target))
+    int start = getEntranceCenter(entrance);
+    int startIdx = entrance.getEntranceLocalIdx();
+    m_workingTargets.clear();
+    m_workingTargetIdxs.clear();
+    for (vector<LocalEntrance>::const_iterator j = m_entrances.begin();
+         j != m_entrances.end(); ++j)
     {
-        m_distances[startIdx][targetIdx] = 
-        m_distances[targetIdx][startIdx] = 
-        computeDistance(start, target, statistics);
+        int targetIdx = j->getEntranceLocalIdx();
+        if (targetIdx == startIdx || m_boolPathMap[startIdx][targetIdx])
+            continue;
+        assert(getEntranceCenter(*j) != start);
+        m_workingTargets.push_back(getEntranceCenter(*j));
+        m_workingTargetIdxs.push_back(targetIdx);
     }
-    else
+    if (m_workingTargets.empty())
+        return;
+    // One search settles all other entrances, unreachable ones get -1
+    SearchPool::DijkstraLease search(searchPool);
+    search->findDistances(m_window, start, m_workingTargets,
+                          m_workingDistances);
+    statistics.add(search->getStatistics());
+    for (vector<int>::size_type i = 0; i < m_workingTargets.size(); ++i)
     {
-        addNoPath(startIdx, targetIdx);
+        int targetIdx = m_workingTargetIdxs[i];
+        if (m_workingDistances[i] < 0)
+            addNoPath(startIdx, targetIdx);
+        else
+            m_distances[startIdx][targetIdx] =
+            m_distances[targetIdx][startIdx] = m_workingDistances[i];
+        m_boolPathMap[startIdx][targetIdx] = (char)1;
+        m_boolPathMap[targetIdx][startIdx] = (char)1;
     }
-    m_boolPathMap[startIdx][targetIdx] = (char)1;
-    m_boolPathMap[targetIdx][startIdx] = (char)1;
 }
 
 const vector<int>& Cluster::computePath(int start, int target,
-                                        StatisticsCollection &statistics)
+                                        StatisticsCollection &statistics,
+                                        SearchPool& searchPool)
 {
-    auto_ptr<Search> search;
-    search.reset(new AStar(false));
-    search->findPath(m_tiling, target, start);
-    const StatisticsCollection& searchStatistics = search->getStatistics();
-    statistics.add(searchStatistics);
+    if (useJumpPointSearch(searchPool))
+    {
+        SearchPool::JumpPointLease search(searchPool);
+        runSearch(*search, m_window, start, target, -1, &statistics);
+        m_workingPath = search->getPath();
+        return m_workingPath;
+    }
+    SearchPool::Lease search(searchPool);
+    runSearch(*search, m_window, start, target, -1, &statistics);
     m_workingPath = search->getPath();
 //      if (m_id == 0 || m_id == 1)
 //      {
@@ -220,32 +245,28 @@ const vector<int>& Cluster::computePath(int start, int target,
     return m_workingPath;
 }
 
-int Cluster::computeDistance(int start, int target, 
-                             StatisticsCollection& statistics)
-{
-    auto_ptr<AStar> search;
-    search.reset(new AStar(false));
-    search->setNodesLimit(1000000);
-    search->findPath(m_tiling, target, start);
-    const StatisticsCollection& searchStatistics = search->getStatistics();
-    statistics.add(searchStatistics);
-    return search->getPathCost();
-}
-
-const vector<int>& Cluster::buildPath(int start, int target)
+const vector<int>& Cluster::buildPath(int start, int target,
+                                      SearchPool& searchPool)
 {
-    auto_ptr<Search> search;
-    search.reset(new AStar(false));
-    search->setNodesLimit(1000000);
-    search->findPath(m_tiling, target, start);
+    if (useJumpPointSearch(searchPool))
+    {
+        SearchPool::JumpPointLease search(searchPool);
+        runSearch(*search, m_window, start, target, 1000000,
+                  static_cast<StatisticsCollection*>(0));
+        m_workingPath = search->getPath();
+        return m_workingPath;
+    }
+    SearchPool::Lease search(searchPool);
+    runSearch(*search, m_window, start, target, 1000000,
+              static_cast<StatisticsCollection*>(0));
     m_workingPath = search->getPath();
     return m_workingPath;
 }
 
-bool Cluster::checkPathExists(int start, int target)
+bool Cluster::useJumpPointSearch(const SearchPool& searchPool) const
 {
-    SearchUtils searchUtils;
-    return searchUtils.checkPathExists(m_tiling, start, target);
+    return (searchPool.getUseJumpPointSearch()
+            && JumpPointSearch::isSupported(m_window.getTiling()));
 }
 
 void Cluster::addPath(const vector<int> &path, int startIdx, int targetIdx)
@@ -14,6 +14,7 @@
 #include "pathfind.h"
 #include "util.h"
 #include "localentrance.h"
+#include "searchpool.h"
 #include "statistics.h"
 
 #define MAX_CLENTRANCES 50
@@ -118,6 +119,10 @@ namespace PathFind
     {
 
     public:
+        /** Constructor.
+            The cluster searches a window of the tiling, which must
+            outlive the cluster.
+        */
         Cluster(const Tiling &tiling, int id, 
                 int row, int col,
                 int horizOrigin, int vertOrigin, 
@@ -129,9 +134,17 @@ namespace PathFind
             return m_id;
         }
 
-        void computePaths(StatisticsCollection &statistics);
+        /** Compute the distances between all entrances.
+            Runs one Dijkstra search per entrance.
+        */
+        void computePaths(StatisticsCollection &statistics,
+                          SearchPool& searchPool);
 
-        void updatePaths(int entranceId, StatisticsCollection &statistics);
+        /** Compute the distances from an entrance to all other entrances
+            that are not known yet.
+        */
+        void updatePaths(int entranceId, StatisticsCollection &statistics,
+                         SearchPool& searchPool);
 
         int getGlobalAbsNodeId(int localIdx) const
         {
@@ -204,11 +217,10 @@ namespace PathFind
 
         int getLocalCenter(int localIndex) const;
 
-        const vector<int>& computePath(int start, int target, StatisticsCollection &statistics);
+        const vector<int>& computePath(int start, int target, StatisticsCollection &statistics,
+                                       SearchPool& searchPool);
 
-        int computeDistance(int start, int target, StatisticsCollection& statistics);
-
-        const vector<int>& buildPath(int start, int target);
+        const vector<int>& buildPath(int start, int target, SearchPool& searchPool);
 
     private:
 
@@ -223,15 +235,29 @@ namespace PathFind
 
         int getEntranceCenter(const LocalEntrance& entrance);
 
-        void computeAddPath(const LocalEntrance& e1, const LocalEntrance& e2,
-                            StatisticsCollection &statistics);
+        /** Compute the distances from an entrance to all entrances
+            without distance in one Dijkstra search.
+        */
+        void computeEntrancePaths(const LocalEntrance& entrance,
+                                  StatisticsCollection &statistics,
+                                  SearchPool& searchPool);
 
-        bool checkPathExists(int start, int target);
+        /** Check if the searches in this cluster should use
+            JumpPointSearch instead of AStar.
+        */
+        bool useJumpPointSearch(const SearchPool& searchPool) const;
 
         vector<int> m_workingPath;
 
+        /** Work space of computeEntrancePaths. */
+        vector<int> m_workingTargets;
+
+        vector<int> m_workingTargetIdxs;
+
+        vector<int> m_workingDistances;
+
     protected:
-        Tiling m_tiling;
+        TilingWindow m_window;
         int m_id;
         int m_row; // abstract row of this cluster (e.g., 1 for the second clusters horizontally)
         int m_column; // abstract col of this cluster (e.g., 1 for the second clusters vertically)
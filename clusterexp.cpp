@@ -53,11 +53,10 @@ void Experiment::addStats(AbStatistics &statistics)
         abFakeSearch.reset(new IDAStar());
         break;
     }
-    SmoothWizard fakeSmooth;
     statistics["pp"] = fakeSearch->createStatistics();
     statistics["st"] = fakeSearch->createStatistics();
     statistics["tg"] = fakeSearch->createStatistics();
-    statistics["sm"] = fakeSmooth.createStatistics();
+    statistics["sm"] = SmoothWizard::createStatistics();
     statistics["ab"] = abFakeSearch->createStatistics();
 }
 
@@ -347,8 +346,8 @@ void Experiment::runAbSearch(Tiling &tiling,
     wizard.getAbsTiling().convertVisitedNodes(abSearch->getVisitedNodes(), 
                                               llVisitedNodes, tiling.getNumberNodes());
     // path smoothing
-    SmoothWizard smooth(tiling, result);
-    smooth.smoothPath();
+    SmoothWizard smooth(tiling);
+    smooth.smoothPath(result);
     if (print && m_contor % 5 == 0)
     {
         tiling.printPathAndLabels(cout, smooth.getSmoothPath(), llVisitedNodes);
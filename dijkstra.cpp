@@ -0,0 +1,215 @@
+//-----------------------------------------------------------------------------
+/** @file dijkstra.cpp
+    @see dijkstra.h
+*/
+//-----------------------------------------------------------------------------
+
+#include "dijkstra.h"
+
+#include <assert.h>
+#include <time.h>
+
+using namespace std;
+using namespace PathFind;
+
+//-----------------------------------------------------------------------------
+
+Dijkstra::Relaxer::Relaxer(Dijkstra& search, int nodeId, int g)
+    : m_search(search),
+      m_nodeId(nodeId),
+      m_g(g),
+      m_numberSuccessors(0)
+{
+}
+
+bool Dijkstra::Relaxer::visit(int target, int cost)
+{
+    ++m_numberSuccessors;
+    m_search.relax(m_nodeId, m_g, target, cost);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+Dijkstra::Dijkstra()
+    : m_isAborted(false),
+      m_pathCost(-1),
+      m_env(0),
+      m_nodesExpanded(0),
+      m_nodesVisited(0),
+      m_numberNodes(0),
+      m_openSize(0),
+      m_statistics(createStatistics()),
+      m_branchingFactor(m_statistics.get("branching_factor")),
+      m_cpuTimeStatistics(m_statistics.get("cpu_time")),
+      m_nodesExpandedStatistics(m_statistics.get("nodes_expanded")),
+      m_nodesVisitedStatistics(m_statistics.get("nodes_visited")),
+      m_openLengthStatistics(m_statistics.get("open_length")),
+      m_openMaxStatistics(m_statistics.get("open_max")),
+      m_pathCostStatistics(m_statistics.get("path_cost")),
+      m_pathLengthStatistics(m_statistics.get("path_length"))
+{
+}
+
+StatisticsCollection Dijkstra::createStatistics()
+{
+    return createBasicStatistics();
+}
+
+bool Dijkstra::findDistances(const Environment& env, int start,
+                             const vector<int>& targets,
+                             vector<int>& distances)
+{
+    assert(env.isValidNodeId(start));
+    clock_t startTime = clock();
+    init(env);
+    int numberTargets = 0;
+    for (vector<int>::const_iterator i = targets.begin();
+         i != targets.end(); ++i)
+    {
+        assert(env.isValidNodeId(*i));
+        if (! m_isTarget.isMarked(*i))
+        {
+            m_isTarget.mark(*i);
+            ++numberTargets;
+        }
+    }
+    searchTargets(start, numberTargets);
+    distances.assign(targets.size(), -1);
+    for (vector<int>::size_type i = 0; i < targets.size(); ++i)
+    {
+        int target = targets[i];
+        if (m_nodeStates.getState(target) != NodeStateArray::CLOSED)
+            continue;
+        distances[i] = m_nodeStates.getG(target);
+        m_pathCostStatistics.add(distances[i]);
+        m_pathLengthStatistics.add(getPathLength(target));
+    }
+    double timeDiff =
+        static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
+    m_cpuTimeStatistics.add(timeDiff);
+    m_nodesExpandedStatistics.add(m_nodesExpanded);
+    m_nodesVisitedStatistics.add(m_nodesVisited);
+    return ! m_isAborted;
+}
+
+bool Dijkstra::findPath(const Environment& env, int start, int target)
+{
+    assert(env.isValidNodeId(start));
+    assert(env.isValidNodeId(target));
+    clock_t startTime = clock();
+    init(env);
+    m_isTarget.mark(target);
+    searchTargets(start, 1);
+    if (m_nodeStates.getState(target) == NodeStateArray::CLOSED)
+    {
+        m_path = m_nodeStates.constructPath(start, target);
+        m_pathCost = m_nodeStates.getG(target);
+        m_pathCostStatistics.add(m_pathCost);
+    }
+    double timeDiff =
+        static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
+    m_cpuTimeStatistics.add(timeDiff);
+    m_nodesExpandedStatistics.add(m_nodesExpanded);
+    m_nodesVisitedStatistics.add(m_nodesVisited);
+    m_pathLengthStatistics.add(m_path.size());
+    return ! m_isAborted;
+}
+
+int Dijkstra::getPathLength(int nodeId) const
+{
+    int length = 0;
+    for ( ; nodeId != NO_NODE; nodeId = m_nodeStates.getParent(nodeId))
+        ++length;
+    return length;
+}
+
+const StatisticsCollection& Dijkstra::getStatistics() const
+{
+    return m_statistics;
+}
+
+const vector<char>& Dijkstra::getVisitedNodes() const
+{
+    return getVisitedNodeLabels(m_numberNodes);
+}
+
+void Dijkstra::init(const Environment& env)
+{
+    m_statistics.clear();
+    m_nodesExpanded = 0;
+    m_nodesVisited = 0;
+    m_env = &env;
+    m_numberNodes = env.getNumberNodes();
+    clearTrace();
+    m_path.clear();
+    m_pathCost = -1;
+    m_isAborted = false;
+    m_nodeStates.init(m_numberNodes);
+    m_isTarget.init(m_numberNodes);
+    m_open.init();
+}
+
+void Dijkstra::relax(int nodeId, int g, int target, int cost)
+{
+    int newg = g + cost;
+    NodeStateArray::State state = m_nodeStates.getState(target);
+    if (state != NodeStateArray::UNSEEN
+        && newg >= m_nodeStates.getG(target))
+        return;
+    // Without heuristic closed nodes are never improved
+    assert(state != NodeStateArray::CLOSED);
+    m_nodeStates.setOpen(target, newg, nodeId);
+    if (state != NodeStateArray::OPEN)
+        ++m_openSize;
+    m_open.insert(target, newg, newg);
+}
+
+void Dijkstra::searchTargets(int start, int numberTargets)
+{
+    int maxOpenSize = 0;
+    m_nodeStates.setOpen(start, 0, NO_NODE);
+    m_open.insert(start, 0, 0);
+    m_openSize = 1;
+    while (numberTargets > 0 && ! m_open.isEmpty())
+    {
+        int nodeId;
+        int g;
+        int f;
+        m_open.pop(nodeId, g, f);
+        // Skip outdated entries
+        if (m_nodeStates.getState(nodeId) != NodeStateArray::OPEN
+            || m_nodeStates.getG(nodeId) != g)
+            continue;
+        if (SAMPLE_EXPANSIONS)
+        {
+            m_openLengthStatistics.add(m_openSize);
+            if (m_openSize > maxOpenSize)
+                maxOpenSize = m_openSize;
+        }
+        m_nodeStates.setClosed(nodeId);
+        --m_openSize;
+        ++m_nodesVisited;
+        traceVisited(nodeId);
+        if (m_isTarget.isMarked(nodeId))
+        {
+            --numberTargets;
+            if (numberTargets == 0)
+                break;
+        }
+        if (m_nodesLimit >= 0 && m_nodesVisited > m_nodesLimit)
+        {
+            m_isAborted = true;
+            break;
+        }
+        ++m_nodesExpanded;
+        Relaxer relaxer(*this, nodeId, g);
+        m_env->visitSuccessors(nodeId, NO_NODE, relaxer);
+        if (SAMPLE_EXPANSIONS)
+            m_branchingFactor.add(relaxer.getNumberSuccessors());
+    }
+    if (SAMPLE_EXPANSIONS)
+        m_openMaxStatistics.add(maxOpenSize);
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,162 @@
+//-----------------------------------------------------------------------------
+/** @file dijkstra.h
+    Dijkstra's algorithm with multiple targets.
+*/
+//-----------------------------------------------------------------------------
+
+#ifndef PATHFIND_DIJKSTRA_H
+#define PATHFIND_DIJKSTRA_H
+
+#include "basicastar.h"
+#include "markerarray.h"
+#include "nodestatearray.h"
+#include "search.h"
+
+//-----------------------------------------------------------------------------
+
+namespace PathFind
+{
+    using namespace std;
+
+    /** Dijkstra search engine.
+        Expands nodes in order of g without heuristic. Besides finding a
+        path to one target, it can compute the distances to several
+        targets in one search, which stops once all targets are settled.
+        Collects the same statistics as AStar, so that they can be added
+        to statistics of AStar searches; in a search for several targets
+        path_cost and path_length are sampled for each reachable target.
+    */
+    class Dijkstra
+        : public Search
+    {
+    public:
+        Dijkstra();
+
+        StatisticsCollection createStatistics();
+
+        /** Find the distances from a node to several targets.
+            getPath() returns an empty path after this search.
+            @param env The environment.
+            @param start The start node.
+            @param targets The target nodes, may contain duplicates.
+            @param distances Returns the path cost for each target,
+            -1 if the target cannot be reached.
+            @return false, if search was aborted due to node limit. The
+            distances of the targets that were not settled are -1.
+        */
+        bool findDistances(const Environment& env, int start,
+                           const vector<int>& targets,
+                           vector<int>& distances);
+
+        /** Find a path.
+            @return false, if search was aborted due to node limit.
+        */
+        bool findPath(const Environment& env, int start, int target);
+
+        const vector<int>& getPath() const
+        {
+            return m_path;
+        }
+
+        int getPathCost() const
+        {
+            return m_pathCost;
+        }
+
+        const StatisticsCollection& getStatistics() const;
+
+        /** Get a vector with '+' char labels for each visited node.
+            @see Search::getVisitedNodes
+        */
+        const vector<char>& getVisitedNodes() const;
+
+    private:
+        class Relaxer;
+
+        friend class Relaxer;
+
+        /** Visitor that relaxes the successors of an expanded node. */
+        class Relaxer
+            : public Environment::SuccessorVisitor
+        {
+        public:
+            Relaxer(Dijkstra& search, int nodeId, int g);
+
+            int getNumberSuccessors() const
+            {
+                return m_numberSuccessors;
+            }
+
+            bool visit(int target, int cost);
+
+        private:
+            Dijkstra& m_search;
+
+            int m_nodeId;
+
+            int m_g;
+
+            int m_numberSuccessors;
+        };
+
+        bool m_isAborted;
+
+        int m_pathCost;
+
+        const Environment* m_env;
+
+        long long int m_nodesExpanded;
+
+        long long int m_nodesVisited;
+
+        /** Number of nodes of the environment in the last search. */
+        int m_numberNodes;
+
+        /** Number of nodes in state OPEN. */
+        int m_openSize;
+
+        NodeStateArray m_nodeStates;
+
+        BasicOpenHeap m_open;
+
+        /** Targets of the current search. */
+        MarkerArray m_isTarget;
+
+        vector<int> m_path;
+
+        StatisticsCollection m_statistics;
+
+        Statistics& m_branchingFactor;
+
+        Statistics& m_cpuTimeStatistics;
+
+        Statistics& m_nodesExpandedStatistics;
+
+        Statistics& m_nodesVisitedStatistics;
+
+        Statistics& m_openLengthStatistics;
+
+        Statistics& m_openMaxStatistics;
+
+        Statistics& m_pathCostStatistics;
+
+        Statistics& m_pathLengthStatistics;
+
+        /** Start a search and mark no targets. */
+        void init(const Environment& env);
+
+        /** Get the number of nodes of the path to a settled node. */
+        int getPathLength(int nodeId) const;
+
+        void relax(int nodeId, int g, int target, int cost);
+
+        /** Run the search until all targets are settled.
+            @param numberTargets Number of distinct marked targets.
+        */
+        void searchTargets(int start, int numberTargets);
+    };
+}
+
+//-----------------------------------------------------------------------------
+
+#endif
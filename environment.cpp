@@ -10,9 +10,35 @@ using namespace PathFind;
 
 //-----------------------------------------------------------------------------
 
+Environment::SuccessorVisitor::~SuccessorVisitor()
+{
+    ;
+}
+
+//-----------------------------------------------------------------------------
+
+bool Environment::SuccessorCollector::visit(int target, int cost)
+{
+    m_result.push_back(Successor(target, cost));
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
 Environment::~Environment()
 {
     ;
 }
 
+void Environment::visitSuccessors(int nodeId, int lastNodeId,
+                                  SuccessorVisitor& visitor) const
+{
+    vector<Successor> successors;
+    getSuccessors(nodeId, lastNodeId, successors);
+    for (vector<Successor>::const_iterator i = successors.begin();
+         i != successors.end(); ++i)
+        if (! visitor.visit(i->m_target, i->m_cost))
+            return;
+}
+
 //-----------------------------------------------------------------------------
@@ -37,6 +37,33 @@ namespace PathFind
             
             int m_cost;
         };
+
+        /** Receiver of the successors enumerated by visitSuccessors(). */
+        class SuccessorVisitor
+        {
+        public:
+            virtual ~SuccessorVisitor();
+
+            /** Handle a successor.
+                @return false, if the enumeration should stop.
+            */
+            virtual bool visit(int target, int cost) = 0;
+        };
+
+        /** Visitor that stores the successors in a vector. */
+        class SuccessorCollector
+            : public SuccessorVisitor
+        {
+        public:
+            explicit SuccessorCollector(vector<Successor>& result)
+                : m_result(result)
+            { }
+
+            bool visit(int target, int cost);
+
+        private:
+            vector<Successor>& m_result;
+        };
         
         virtual ~Environment();
         
@@ -55,6 +82,15 @@ namespace PathFind
         */
         virtual void getSuccessors(int nodeId, int lastNodeId,
                                    vector<Successor>& result) const = 0;
+
+        /** Enumerate successor nodes for the search.
+            Visits the same successors in the same order as getSuccessors(),
+            but without storing them.
+            The default implementation uses getSuccessors(), subclasses
+            should override it with a version that does not allocate.
+        */
+        virtual void visitSuccessors(int nodeId, int lastNodeId,
+                                     SuccessorVisitor& visitor) const;
         
         virtual bool isValidNodeId(int nodeId) const = 0;
     };        
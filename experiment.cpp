@@ -23,10 +23,6 @@ float heurReport;
 
 //-----------------------------------------------------------------------------
 
-typedef enum {A_STAR, IDA_STAR} SearchAlgorithm;
-
-//-----------------------------------------------------------------------------
-
 Experiment::Experiment(int nrRuns, long long int nodesLimit, int rows, int columns,
                        float obstaclePercentage, bool ll, bool ab, bool cl,
                        int clusterSize, int level, AbsWizard::EntranceStyle entrStyle,
@@ -43,7 +39,10 @@ Experiment::Experiment(int nrRuns, long long int nodesLimit, int rows, int colum
      m_maxLevel(level),
      m_entrStyle(entrStyle),
      m_searchAlgorithm(searchAlgorithm),
-     m_tilingType(type)
+     m_tilingType(type),
+     m_suboptimalityBound(1),
+     m_suboptimalMode(AStar::SUBOPTIMAL_WEIGHTED),
+     m_numberThreads(1)
 {
 }
 
@@ -60,6 +59,7 @@ void Experiment::runExperiment()
         tiling.setObstacles(m_obstaclePercentage);
 
         AbsWizard wizard(tiling, m_clusterSize, m_maxLevel, m_entrStyle);
+        SmoothWizard smooth(tiling);
         if (m_ab || m_bClStats)
         {
             abstractMaze(tiling, wizard);
@@ -93,7 +93,7 @@ void Experiment::runExperiment()
                 for (int level = 1; level <=m_maxLevel; level++)
                 {
                     cerr << " " << level << " ";
-                    runAbSearch(tiling, wizard, level, false);
+                    runAbSearch(tiling, wizard, smooth, level, false);
                 }
                 removeSTAL(wizard);
                 cerr << "\n";
@@ -124,6 +124,7 @@ void Experiment::runExperiment(string fileName)
         exit(1);
     }
     AbsWizard wizard(tiling, m_clusterSize, m_maxLevel, m_entrStyle);
+    SmoothWizard smooth(tiling);
     if (m_ab || m_bClStats)
     {
         abstractMaze(tiling, wizard);
@@ -151,7 +152,7 @@ void Experiment::runExperiment(string fileName)
             for (int level = m_maxLevel; level >= 1; level--)
             {
                 cerr << " " << level << " ";
-                runAbSearch(tiling, wizard, level, false);
+                runAbSearch(tiling, wizard, smooth, level, false);
             }
             removeSTAL(wizard);
         }
@@ -227,35 +228,46 @@ StatisticsCollection Experiment::createHeurStatistics()
     return collection;
 }
 
+StatisticsCollection Experiment::createCostRatioStatistics()
+{
+    StatisticsCollection collection;
+    collection.create("cost_ratio");
+    return collection;
+}
+
+void Experiment::setSuboptimalityBound(double bound,
+                                       AStar::SuboptimalMode mode)
+{
+    if (bound < 1)
+        throw Error("Suboptimality bound must be at least 1.");
+    m_suboptimalityBound = bound;
+    m_suboptimalMode = mode;
+}
+
+void Experiment::setNumberThreads(int numberThreads)
+{
+    if (numberThreads < 1)
+        throw Error("Number of threads must be at least 1.");
+    m_numberThreads = numberThreads;
+}
+
 
 void Experiment::setupExperiment()
 {
     if (m_ll)
     {
         Tiling fakeTiling(Tiling::OCTILE, 1, 1);
-        auto_ptr<Search> fakeSearch;
-        fakeSearch.reset(new AStar(false));
+        auto_ptr<Search> fakeSearch(createLlSearch());
         for (int k = 0; k < REFINEMENT_LEVELS; k++)
             m_llStatistics[k] = fakeSearch->createStatistics();
         m_llStorageStatistics = fakeTiling.createStorageStatistics();
     }
     if (m_ab || m_bClStats)
     {
-        auto_ptr<Search> fakeSearch, abFakeSearch;
-        fakeSearch.reset(new AStar(false));
-        switch (m_searchAlgorithm)
-        {
-        case A_STAR:
-            abFakeSearch.reset(new AStar(false));
-            break;
-        case IDA_STAR:
-            abFakeSearch.reset(new IDAStar());
-            break;
-        }
-        SmoothWizard fakeSmooth;
+        auto_ptr<Search> fakeSearch(new AStar(false));
         for (int k = 0; k < REFINEMENT_LEVELS; k++)
         {
-            m_smoothStatistics[k] = fakeSmooth.createStatistics();
+            m_smoothStatistics[k] = SmoothWizard::createStatistics();
             for (int i = 0; i <= m_maxLevel; i++)
             {
                 m_preStatistics[k][i] = fakeSearch->createStatistics();
@@ -263,6 +275,7 @@ void Experiment::setupExperiment()
                 m_stStatistics[k][i] = fakeSearch->createStatistics();
                 m_abMainSearchStatistics[k][i] = fakeSearch->createStatistics();
                 m_abInterSearchStatistics[k][i] = fakeSearch->createStatistics();
+                m_costRatioStatistics[k][i] = createCostRatioStatistics();
             }
         }
     }
@@ -288,6 +301,12 @@ void Experiment::printHeader(SearchAlgorithm searchAlgorithm, Tiling::Type type)
     case IDA_STAR:
         cerr << "IDA_STAR";
         break;
+    case BIDIRECTIONAL_A_STAR:
+        cerr << "BIDIRECTIONAL_A_STAR";
+        break;
+    case FRINGE_SEARCH:
+        cerr << "FRINGE_SEARCH";
+        break;
     }
     cerr << "  ";
     switch (type)
@@ -306,6 +325,15 @@ void Experiment::printHeader(SearchAlgorithm searchAlgorithm, Tiling::Type type)
         break;
     }
     cerr << '\n';
+    if (m_suboptimalityBound > 1)
+    {
+        cerr << "Suboptimality bound: " << m_suboptimalityBound << ' '
+             << (m_suboptimalMode == AStar::SUBOPTIMAL_FOCAL ? "FOCAL"
+                 : "WEIGHTED")
+             << '\n';
+    }
+    if (m_numberThreads > 1)
+        cerr << "Threads: " << m_numberThreads << '\n';
     cerr << "==============================================================\n";
 }
 
@@ -375,6 +403,8 @@ void Experiment::printAbStatistics(ostream& o, int k)
     {
         o << "at level " << i << ":\n";
         m_abMainSearchStatistics[k][i].print(o);
+        if (m_ll)
+            m_costRatioStatistics[k][i].print(o);
     }
     o << "ABI\tAbstract intermediate search:\n";
     for (int i = 0; i < m_maxLevel; i++)
@@ -409,19 +439,28 @@ void Experiment::printAbStatistics(ostream& o, int k)
     }
 }
 
-void Experiment::runLlSearch(Tiling &tiling, int start, int target, bool print)
+Search* Experiment::createLlSearch() const
 {
-    auto_ptr<Search> llSearch;
     switch (m_searchAlgorithm)
     {
-    case A_STAR:
-        llSearch.reset(new AStar(true));
-        break;
     case IDA_STAR:
-        llSearch.reset(new IDAStar());
+        return new IDAStar();
+    case BIDIRECTIONAL_A_STAR:
+        return new BidirectionalAStar();
+    case FRINGE_SEARCH:
+        return new FringeSearch();
+    case A_STAR:
         break;
     }
+    return new AStar(AStar::CLOSED_AUTO);
+}
+
+void Experiment::runLlSearch(Tiling &tiling, int start, int target, bool print)
+{
+    auto_ptr<Search> llSearch(createLlSearch());
     llSearch->setNodesLimit(m_nodesLimit);
+    if (print)
+        llSearch->setTraceMode(Search::TRACE_VISITED);
     llSearch->findPath(tiling, start, target);
     const vector<int>& path1 = llSearch->getPath();
     llLength = tiling.getPathCost(path1);
@@ -453,6 +492,7 @@ void Experiment::abstractMaze(Tiling &tiling, AbsWizard &wizard)
 {
     cerr << " AB...";
     cerr << " pp...";
+    wizard.getAbsTiling().setNumberThreads(m_numberThreads);
     wizard.abstractMaze();
     const HTiling& absTiling = wizard.getAbsTiling();
     for (int i = 0; i <= m_maxLevel; i++)
@@ -484,36 +524,26 @@ void Experiment::removeSTAL(AbsWizard& wizard)
     cerr << "\n";
 }
 
-void Experiment::runAbSearch(Tiling &tiling, AbsWizard& wizard, int level, bool print)
+void Experiment::runAbSearch(Tiling &tiling, AbsWizard& wizard,
+                             SmoothWizard& smooth, int level, bool print)
 {
-    auto_ptr<Search> abSearch;
-    switch (m_searchAlgorithm)
-    {
-    case A_STAR:
-        abSearch.reset(new AStar(true));
-        break;
-    case IDA_STAR:
-        abSearch.reset(new IDAStar());
-        break;
-    }
-    abSearch->setNodesLimit(m_nodesLimit);
     HTiling& absTiling = wizard.getAbsTiling();
     //    cerr << " searching...";
     vector<int> path2;
-    absTiling.doHierarchicalSearch(m_absStart, m_absTarget, path2, level);
+    absTiling.doHierarchicalSearch(m_absStart, m_absTarget, path2, level,
+                                   m_suboptimalityBound, m_suboptimalMode);
     //    cerr << " path conversion...";
     vector<int> result;
     absTiling.absPath2llPath2(path2, result, wizard.getTiling().getWidth());
-    vector<char> llVisitedNodes;
-    absTiling.convertVisitedNodes(abSearch->getVisitedNodes(),
-                                  llVisitedNodes, tiling.getNumberNodes());
+    if (m_ll && llLength > 0)
+        m_costRatioStatistics[heurStatsIndex][level].get("cost_ratio")
+            .add(static_cast<double>(tiling.getPathCost(result)) / llLength);
     // path smoothing
     //    cerr << "path smoothing...";
-    SmoothWizard smooth(tiling, result);
-    smooth.smoothPath();
+    smooth.smoothPath(result);
     if (print && m_contor % 10 == 0)
     {
-        tiling.printPathAndLabels(cout, smooth.getSmoothPath(), llVisitedNodes);
+        tiling.printFormatted(cout, smooth.getSmoothPath());
         cout << "\n";
     }
     abLength = tiling.getPathCost(smooth.getSmoothPath());
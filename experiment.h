@@ -8,6 +8,7 @@
 #include "pathfind.h"
 #include "util.h"
 #include "abswizard.h"
+#include "smoothwizard.h"
 #include <sstream>
 
 //-----------------------------------------------------------------------------
@@ -16,7 +17,16 @@ namespace PathFind
 {
     typedef map<string, StatisticsCollection> AbStatistics;
 
-    typedef enum {A_STAR, IDA_STAR} SearchAlgorithm;
+    /** Engine of the low-level search of an Experiment.
+        The abstract searches of HTiling always use AStar, because they
+        run the hierarchical search with the step API of AStar.
+    */
+    typedef enum {
+        A_STAR,
+        IDA_STAR,
+        BIDIRECTIONAL_A_STAR,
+        FRINGE_SEARCH
+    } SearchAlgorithm;
 
     static const int REFINEMENT_LEVELS = 40;
 
@@ -36,6 +46,22 @@ namespace PathFind
         void runStorageExperiment(string fileName);
         void setupExperiment();
 
+        /** Suboptimality bound for the abstract main search.
+            The low-level search stays optimal, it is needed for the
+            cost ratio of the abstract paths.
+            @see AStar::setSuboptimalityBound
+        */
+        void setSuboptimalityBound(double bound,
+                                   AStar::SuboptimalMode mode
+                                   = AStar::SUBOPTIMAL_WEIGHTED);
+
+        /** Number of threads for the pre-processing of the abstraction.
+            The default is 1.
+            @see AbsTiling::setNumberThreads
+            @throws Error, if numberThreads is smaller than 1.
+        */
+        void setNumberThreads(int numberThreads);
+
     private:
         void printHeader(SearchAlgorithm searchAlgorithm, Tiling::Type type);
 
@@ -51,11 +77,17 @@ namespace PathFind
 
         StatisticsCollection& getAbSubStats(const string &name);
 
+        /** Create the engine of the low-level search.
+            Also used for the layout of the low-level statistics.
+        */
+        Search* createLlSearch() const;
+
         void runLlSearch(Tiling &tiling, 
                          int start, int target, 
                          bool print);
 
-        void runAbSearch(Tiling &tiling, AbsWizard& wizard, int level, bool print);
+        void runAbSearch(Tiling &tiling, AbsWizard& wizard,
+                         SmoothWizard& smooth, int level, bool print);
 
         void abstractMaze(Tiling &tiling, AbsWizard& wizard);
 
@@ -65,6 +97,8 @@ namespace PathFind
 
         StatisticsCollection createHeurStatistics();
 
+        StatisticsCollection createCostRatioStatistics();
+
         void printStorageStatistics(ostream& o);
 
 
@@ -86,6 +120,9 @@ namespace PathFind
         AbsWizard::EntranceStyle m_entrStyle;
         SearchAlgorithm m_searchAlgorithm;
         Tiling::Type m_tilingType;
+        double m_suboptimalityBound;
+        AStar::SuboptimalMode m_suboptimalMode;
+        int m_numberThreads;
         StatisticsCollection m_smoothStatistics[REFINEMENT_LEVELS];
         StatisticsCollection m_storageStatistics[REFINEMENT_LEVELS][MAX_LEVELS];
         StatisticsCollection m_preStatistics[REFINEMENT_LEVELS][MAX_LEVELS];
@@ -93,6 +130,8 @@ namespace PathFind
         StatisticsCollection m_tgStatistics[REFINEMENT_LEVELS][MAX_LEVELS];
         StatisticsCollection m_abMainSearchStatistics[REFINEMENT_LEVELS][MAX_LEVELS];
         StatisticsCollection m_abInterSearchStatistics[REFINEMENT_LEVELS][MAX_LEVELS];
+        /** Cost of refined abstract path divided by optimal path cost. */
+        StatisticsCollection m_costRatioStatistics[REFINEMENT_LEVELS][MAX_LEVELS];
         StatisticsCollection m_llStatistics[REFINEMENT_LEVELS];
         StatisticsCollection m_heurDiffStatistics[REFINEMENT_LEVELS];
         StatisticsCollection m_heurReportStatistics[REFINEMENT_LEVELS];
@@ -0,0 +1,209 @@
+//-----------------------------------------------------------------------------
+/** @file fringesearch.cpp
+    @see fringesearch.h
+*/
+//-----------------------------------------------------------------------------
+
+#include "fringesearch.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+using namespace std;
+using namespace PathFind;
+
+//-----------------------------------------------------------------------------
+
+FringeSearch::Relaxer::Relaxer(FringeSearch& search, int nodeId, int g)
+    : m_search(search),
+      m_nodeId(nodeId),
+      m_g(g),
+      m_numberSuccessors(0)
+{
+}
+
+bool FringeSearch::Relaxer::visit(int target, int cost)
+{
+    ++m_numberSuccessors;
+    m_search.relax(m_nodeId, m_g, target, cost);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+FringeSearch::FringeSearch()
+    : m_isAborted(false),
+      m_pathCost(-1),
+      m_target(NO_NODE),
+      m_env(0),
+      m_nodesExpanded(0),
+      m_nodesVisited(0),
+      m_numberNodes(0),
+      m_fringeSize(0),
+      m_statistics(createStatistics()),
+      m_branchingFactor(m_statistics.get("branching_factor")),
+      m_cpuTimeStatistics(m_statistics.get("cpu_time")),
+      m_iterationsStatistics(m_statistics.get("iterations")),
+      m_nodesExpandedStatistics(m_statistics.get("nodes_expanded")),
+      m_nodesVisitedStatistics(m_statistics.get("nodes_visited")),
+      m_openLengthStatistics(m_statistics.get("open_length")),
+      m_openMaxStatistics(m_statistics.get("open_max")),
+      m_pathCostStatistics(m_statistics.get("path_cost")),
+      m_pathLengthStatistics(m_statistics.get("path_length"))
+{
+}
+
+inline void FringeSearch::insertAfter(int nodeId, int position)
+{
+    int next = m_next[position];
+    m_next[nodeId] = next;
+    m_prev[nodeId] = position;
+    m_prev[next] = nodeId;
+    m_next[position] = nodeId;
+}
+
+inline void FringeSearch::remove(int nodeId)
+{
+    int next = m_next[nodeId];
+    int prev = m_prev[nodeId];
+    m_next[prev] = next;
+    m_prev[next] = prev;
+}
+
+StatisticsCollection FringeSearch::createStatistics()
+{
+    StatisticsCollection collection = createBasicStatistics();
+    collection.create("iterations");
+    return collection;
+}
+
+bool FringeSearch::findPath(const Environment& env, int start, int target)
+{
+    assert(env.isValidNodeId(start));
+    assert(env.isValidNodeId(target));
+    clock_t startTime = clock();
+    m_statistics.clear();
+    m_nodesExpanded = 0;
+    m_nodesVisited = 0;
+    m_env = &env;
+    m_numberNodes = env.getNumberNodes();
+    m_target = target;
+    clearTrace();
+    m_path.clear();
+    m_pathCost = -1;
+    m_isAborted = false;
+    findPathFringe(start);
+    double timeDiff =
+        static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
+    m_cpuTimeStatistics.add(timeDiff);
+    m_nodesExpandedStatistics.add(m_nodesExpanded);
+    m_nodesVisitedStatistics.add(m_nodesVisited);
+    m_pathLengthStatistics.add(m_path.size());
+    return ! m_isAborted;
+}
+
+void FringeSearch::findPathFringe(int start)
+{
+    const int head = m_numberNodes;
+    if (static_cast<int>(m_next.size()) <= head)
+    {
+        m_next.resize(head + 1);
+        m_prev.resize(head + 1);
+    }
+    m_next[head] = head;
+    m_prev[head] = head;
+    m_nodeStates.init(m_numberNodes);
+    m_nodeStates.setOpen(start, 0, NO_NODE);
+    insertAfter(start, head);
+    m_fringeSize = 1;
+    int maxFringeSize = 0;
+    int fLimit = m_env->getHeuristic(start, m_target);
+    int iterations = 0;
+    bool isPathFound = false;
+    while (m_next[head] != head && ! isPathFound && ! m_isAborted)
+    {
+        ++iterations;
+        int nextFLimit = INT_MAX;
+        int nodeId = m_next[head];
+        while (nodeId != head)
+        {
+            int g = m_nodeStates.getG(nodeId);
+            int f = g + m_env->getHeuristic(nodeId, m_target);
+            if (f > fLimit)
+            {
+                // Stays in the fringe for the next iteration
+                if (f < nextFLimit)
+                    nextFLimit = f;
+                nodeId = m_next[nodeId];
+                continue;
+            }
+            ++m_nodesVisited;
+            traceVisited(nodeId);
+            if (nodeId == m_target)
+            {
+                isPathFound = true;
+                break;
+            }
+            if (m_nodesLimit >= 0 && m_nodesVisited > m_nodesLimit)
+            {
+                m_isAborted = true;
+                break;
+            }
+            if (SAMPLE_EXPANSIONS)
+            {
+                m_openLengthStatistics.add(m_fringeSize);
+                if (m_fringeSize > maxFringeSize)
+                    maxFringeSize = m_fringeSize;
+            }
+            ++m_nodesExpanded;
+            // Successors are inserted after the node and scanned next
+            Relaxer relaxer(*this, nodeId, g);
+            m_env->visitSuccessors(nodeId, NO_NODE, relaxer);
+            if (SAMPLE_EXPANSIONS)
+                m_branchingFactor.add(relaxer.getNumberSuccessors());
+            int next = m_next[nodeId];
+            remove(nodeId);
+            m_nodeStates.setClosed(nodeId);
+            --m_fringeSize;
+            nodeId = next;
+        }
+        fLimit = nextFLimit;
+    }
+    m_iterationsStatistics.add(iterations);
+    if (isPathFound)
+    {
+        m_path = m_nodeStates.constructPath(start, m_target);
+        m_pathCost = m_nodeStates.getG(m_target);
+        m_pathCostStatistics.add(m_pathCost);
+    }
+    if (SAMPLE_EXPANSIONS)
+        m_openMaxStatistics.add(maxFringeSize);
+}
+
+const StatisticsCollection& FringeSearch::getStatistics() const
+{
+    return m_statistics;
+}
+
+const vector<char>& FringeSearch::getVisitedNodes() const
+{
+    return getVisitedNodeLabels(m_numberNodes);
+}
+
+void FringeSearch::relax(int nodeId, int g, int target, int cost)
+{
+    int newg = g + cost;
+    NodeStateArray::State state = m_nodeStates.getState(target);
+    if (state != NodeStateArray::UNSEEN
+        && newg >= m_nodeStates.getG(target))
+        return;
+    if (state == NodeStateArray::OPEN)
+        remove(target);
+    else
+        ++m_fringeSize;
+    m_nodeStates.setOpen(target, newg, nodeId);
+    insertAfter(target, nodeId);
+}
+
+//-----------------------------------------------------------------------------
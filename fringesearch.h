@@ -0,0 +1,176 @@
+//-----------------------------------------------------------------------------
+/** @file fringesearch.h
+    Fringe search.
+
+    Short description of fringe search:
+
+    Like IDA*, the search runs iterations with an increasing threshold
+    for f = g + h, starting with the heuristic of the start node. Instead
+    of starting each iteration again at the start node, it keeps the
+    frontier of the previous iteration (the fringe) in a list and the g
+    values of all nodes seen in a cache. An iteration scans the list from
+    left to right: nodes with f above the threshold stay in the list for
+    the next iteration, other nodes are expanded and replaced by their
+    successors, which are inserted right after the expanded node, so that
+    they are scanned in the same iteration. The threshold of the next
+    iteration is the smallest f value that exceeded the threshold. No
+    priority queue is needed, the fringe is a linked list.
+
+    See Y. Bjornsson, M. Enzenberger, R. Holte, J. Schaeffer: Fringe
+    Search: Beating A* at Pathfinding on Game Maps (CIG 2005).
+*/
+//-----------------------------------------------------------------------------
+
+#ifndef PATHFIND_FRINGESEARCH_H
+#define PATHFIND_FRINGESEARCH_H
+
+#include "nodestatearray.h"
+#include "search.h"
+
+//-----------------------------------------------------------------------------
+
+namespace PathFind
+{
+    using namespace std;
+
+    /** Fringe search engine.
+        Uses a NodeStateArray as the cache, like AStar with
+        CLOSED_NODE_STATES: nodes in the fringe are OPEN, nodes that were
+        removed from the fringe after expansion are CLOSED. The fringe is
+        a doubly linked list stored in arrays indexed by node id. Finds
+        optimal paths if the heuristic is admissible, nodes whose g value
+        decreases after expansion are inserted into the fringe again.
+        Collects the same statistics as AStar, with open_length being the
+        length of the fringe, and the number of iterations (iterations).
+    */
+    class FringeSearch
+        : public Search
+    {
+    public:
+        FringeSearch();
+
+        StatisticsCollection createStatistics();
+
+        /** Find a path.
+            @return false, if search was aborted due to node limit.
+        */
+        bool findPath(const Environment& env, int start, int target);
+
+        const vector<int>& getPath() const
+        {
+            return m_path;
+        }
+
+        int getPathCost() const
+        {
+            return m_pathCost;
+        }
+
+        const StatisticsCollection& getStatistics() const;
+
+        /** Get a vector with '+' char labels for each visited node.
+            @see Search::getVisitedNodes
+        */
+        const vector<char>& getVisitedNodes() const;
+
+    private:
+        class Relaxer;
+
+        friend class Relaxer;
+
+        /** Visitor that inserts the improved successors of an expanded
+            node into the fringe.
+        */
+        class Relaxer
+            : public Environment::SuccessorVisitor
+        {
+        public:
+            Relaxer(FringeSearch& search, int nodeId, int g);
+
+            int getNumberSuccessors() const
+            {
+                return m_numberSuccessors;
+            }
+
+            bool visit(int target, int cost);
+
+        private:
+            FringeSearch& m_search;
+
+            int m_nodeId;
+
+            int m_g;
+
+            int m_numberSuccessors;
+        };
+
+        bool m_isAborted;
+
+        int m_pathCost;
+
+        int m_target;
+
+        const Environment* m_env;
+
+        long long int m_nodesExpanded;
+
+        long long int m_nodesVisited;
+
+        /** Number of nodes of the environment in the last search. */
+        int m_numberNodes;
+
+        /** Number of nodes in the fringe. */
+        int m_fringeSize;
+
+        /** Cache with g value and parent of all nodes seen.
+            OPEN nodes are in the fringe.
+        */
+        NodeStateArray m_nodeStates;
+
+        /** Successor of a node in the fringe.
+            The list is circular, the element at index m_numberNodes is
+            the head. Only valid for the head and OPEN nodes.
+        */
+        vector<int> m_next;
+
+        /** Predecessor of a node in the fringe.
+            @see m_next
+        */
+        vector<int> m_prev;
+
+        vector<int> m_path;
+
+        StatisticsCollection m_statistics;
+
+        Statistics& m_branchingFactor;
+
+        Statistics& m_cpuTimeStatistics;
+
+        Statistics& m_iterationsStatistics;
+
+        Statistics& m_nodesExpandedStatistics;
+
+        Statistics& m_nodesVisitedStatistics;
+
+        Statistics& m_openLengthStatistics;
+
+        Statistics& m_openMaxStatistics;
+
+        Statistics& m_pathCostStatistics;
+
+        Statistics& m_pathLengthStatistics;
+
+        void findPathFringe(int start);
+
+        /** Insert a node into the fringe after another node. */
+        void insertAfter(int nodeId, int position);
+
+        void relax(int nodeId, int g, int target, int cost);
+
+        void remove(int nodeId);
+    };
+}
+
+//-----------------------------------------------------------------------------
+
+#endif
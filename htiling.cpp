@@ -56,21 +56,156 @@ void HTiling::clearStatistics()
     }
 }
 
+//-----------------------------------------------------------------------------
+
+HTiling::SearchContext::SearchContext(const HTiling& tiling)
+    : m_tiling(tiling),
+      m_level(1),
+      m_row1(0),
+      m_row2(tiling.m_rows - 1),
+      m_col1(0),
+      m_col2(tiling.m_columns - 1)
+{
+}
+
+int HTiling::SearchContext::getHeuristic(int start, int target) const
+{
+    return m_tiling.getHeuristic(start, target);
+}
+
+int HTiling::SearchContext::getMaxCost() const
+{
+    return m_tiling.getMaxCost();
+}
+
+int HTiling::SearchContext::getMinCost() const
+{
+    return m_tiling.getMinCost();
+}
+
+int HTiling::SearchContext::getNumberNodes() const
+{
+    return m_tiling.getNumberNodes();
+}
+
+void HTiling::SearchContext::getSuccessors(int nodeId, int lastNodeId,
+                                           vector<Successor>& result) const
+{
+    result.reserve(getMaxEdges());
+    result.clear();
+    SuccessorCollector collector(result);
+    visitSuccessors(nodeId, lastNodeId, collector);
+}
+
+bool HTiling::SearchContext::isInCluster(const AbsTilingNodeInfo& nodeInfo)
+    const
+{
+    int nodeRow = nodeInfo.getCenterRow();
+    int nodeCol = nodeInfo.getCenterCol();
+    if (nodeRow < m_row1 || nodeRow > m_row2)
+    {
+        return false;
+    }
+    if (nodeCol < m_col1 || nodeCol > m_col2)
+    {
+        return false;
+    }
+    return true;
+}
+
+bool HTiling::SearchContext::isValidNodeId(int nodeId) const
+{
+    return m_tiling.isValidNodeId(nodeId);
+}
+
+void HTiling::SearchContext::setCluster(int nodeId, int level)
+{
+    if (level > m_tiling.m_maxLevel)
+    {
+        m_row1 = 0;
+        m_row2 = m_tiling.m_rows - 1;
+        m_col1 = 0;
+        m_col2 = m_tiling.m_columns - 1;
+        return;
+    }
+    int offset = m_tiling.getOffset(level);
+    int nodeRow = nodeId/m_tiling.m_columns;
+    int nodeCol = nodeId%m_tiling.m_columns;
+    setCluster(nodeRow - (nodeRow%offset), nodeCol - (nodeCol%offset),
+               offset);
+}
+
+void HTiling::SearchContext::setCluster(int row, int col, int offset)
+{
+    m_row1 = row;
+    m_row2 = min(m_tiling.m_rows - 1, row + offset - 1);
+    m_col1 = col;
+    m_col2 = min(m_tiling.m_columns - 1, col + offset - 1);
+}
+
+void HTiling::SearchContext::setSearch(int startNodeId, int level,
+                                       bool mainSearch)
+{
+    m_level = level;
+    const AbsTilingNodeInfo& nodeInfo =
+        m_tiling.m_graph.getNodeInfo(startNodeId);
+    if (mainSearch)
+        setCluster(nodeInfo.getCenterId(), m_tiling.m_maxLevel + 1);
+    else
+        setCluster(nodeInfo.getCenterId(), level + 1);
+}
+
+void HTiling::SearchContext::visitSuccessors(int nodeId, int lastNodeId,
+                                             SuccessorVisitor& visitor) const
+{
+    const AbsTilingNode& node = m_tiling.m_graph.getNode(nodeId);
+    const vector<AbsTilingEdge>& edges = node.getOutEdges();
+    for (vector<AbsTilingEdge>::const_iterator i = edges.begin();
+         i != edges.end(); ++i)
+    {
+        if (i->getInfo().getInter())
+        {
+            if (i->getInfo().getLevel() < m_level)
+                continue;
+        }
+        else
+        {
+            if (i->getInfo().getLevel() != m_level)
+                continue;
+        }
+        int targetNodeId = i->getTargetNodeId();
+        assert(isValidNodeId(targetNodeId));
+        const AbsTilingNodeInfo& targetNodeInfo =
+            m_tiling.m_graph.getNodeInfo(targetNodeId);
+        if (targetNodeInfo.getLevel() < m_level)
+            continue;
+        if (! isInCluster(targetNodeInfo))
+            continue;
+        // prune if target node is in the same cluster as last node
+        if (lastNodeId != NO_NODE)
+            if (m_tiling.sameCluster(targetNodeId, lastNodeId, m_level))
+                continue;
+        if (! visitor.visit(targetNodeId, i->getInfo().getCost()))
+            return;
+    }
+}
+
 //-----------------------------------------------------------------------------
 // method override
 
 void HTiling::insertStalHEdges(int nodeId, int nodeRow, int nodeCol)
 {
-    AStar search(false);
+    SearchPool::Lease search(m_searchPool);
+    SearchContext context(*this);
     AbsTilingNodeInfo& nodeInfo = m_graph.getNodeInfo(m_absNodeIds[nodeId]);
     int oldLevel = nodeInfo.getLevel();
     nodeInfo.setLevel(m_maxLevel);
     for (int level = oldLevel + 1; level <= m_maxLevel; level++)
     {
-        m_currentLevel = level - 1;
-        setCurrentCluster(nodeId, level);
-        for (int i2 = m_currentRow1; i2 <= m_currentRow2; i2++)
-        for (int j2 = m_currentCol1; j2 <= m_currentCol2; j2++)
+        context.setLevel(level - 1);
+        context.setCluster(nodeId, level);
+        for (int i2 = context.getRow1(); i2 <= context.getRow2(); i2++)
+        for (int j2 = context.getCol1(); j2 <= context.getCol2(); j2++)
         {
             if (m_absNodeIds[i2*m_columns+j2] == NO_NODE)
                 continue;
@@ -80,17 +215,17 @@ void HTiling::insertStalHEdges(int nodeId, int nodeRow, int nodeCol)
             if (nodeInfo2.getLevel() < level)
                 continue;
             {
-                search.findPath(*this, m_absNodeIds[nodeId], m_absNodeIds[i2*m_columns+j2]);
-                const StatisticsCollection& searchStatistics = search.getStatistics();
+                search->findPath(context, m_absNodeIds[nodeId], m_absNodeIds[i2*m_columns+j2]);
+                const StatisticsCollection& searchStatistics = search->getStatistics();
                 m_stStatistics[level - 1].add(searchStatistics);
-                if (search.getPathCost() >= 0)
+                if (search->getPathCost() >= 0)
                 {
                     addOutEdge(m_absNodeIds[nodeId],
                                m_absNodeIds[i2*m_columns+j2],
-                               search.getPathCost(), level, false);
+                               search->getPathCost(), level, false);
                     addOutEdge(m_absNodeIds[i2*m_columns+j2],
                                m_absNodeIds[nodeId],
-                               search.getPathCost(), level, false);
+                               search->getPathCost(), level, false);
                     m_storageStatistics[level].get("intra_edges").add(1);
                 }
             }
@@ -105,41 +240,6 @@ int HTiling::insertSTAL(int nodeId, int nodeRow, int nodeCol, int start)
     return result;
 }
 
-void HTiling::getSuccessors(int nodeId, int lastNodeId,
-                           vector<Successor>& result) const
-{
-    result.reserve(getMaxEdges());
-    result.clear();
-    const AbsTilingNode& node = m_graph.getNode(nodeId);
-    const vector<AbsTilingEdge>& edges = node.getOutEdges();
-    for (vector<AbsTilingEdge>::const_iterator i = edges.begin();
-         i != edges.end(); ++i)
-    {
-        if (i->getInfo().getInter())
-        {
-            if (i->getInfo().getLevel() < m_currentLevel)
-                continue;
-        }
-        else
-        {
-            if (i->getInfo().getLevel() != m_currentLevel)
-                continue;
-        }
-        int targetNodeId = i->getTargetNodeId();
-        assert(isValidNodeId(targetNodeId));
-        const AbsTilingNodeInfo& targetNodeInfo = m_graph.getNodeInfo(targetNodeId);
-        if (targetNodeInfo.getLevel() < m_currentLevel)
-            continue;
-        if (!nodeInCurrentCluster(targetNodeInfo))
-            continue;
-        if (lastNodeId != NO_NODE)
-            if (pruneNode(targetNodeId, nodeId, lastNodeId))
-                continue;
-        result.push_back(Successor(targetNodeId, i->getInfo().getCost()));
-    }
-}
-
-
 void HTiling::printSuccTime()
 {
     //    cout << "get successors time: " << m_succTime << "\n";
@@ -148,25 +248,6 @@ void HTiling::printSuccTime()
 //------------------------------------------------------------------------------
 // set/get methods
 
-void HTiling::setCurrentCluster(int nodeId, int level)
-{
-    if (level > m_maxLevel)
-    {
-        m_currentRow1 = 0;
-        m_currentRow2 = m_rows - 1;
-        m_currentCol1 = 0;
-        m_currentCol2 = m_columns - 1;
-        return;
-    }
-    int offset = getOffset(level);
-    int nodeRow = nodeId/m_columns;
-    int nodeCol = nodeId%m_columns;
-    m_currentRow1 = nodeRow - (nodeRow%offset);
-    m_currentRow2 = min(m_rows - 1, m_currentRow1 + offset - 1);
-    m_currentCol1 = nodeCol - (nodeCol%offset);
-    m_currentCol2 = min(m_columns - 1, m_currentCol1 + offset - 1);
-}
-
 bool HTiling::sameCluster(int node1Id, int node2Id, int level) const
 {
     const AbsTilingNodeInfo& node1Info = m_graph.getNodeInfo(node1Id);
@@ -192,14 +273,6 @@ bool HTiling::sameCluster(int node1Id, int node2Id, int level) const
     return true;
 }
 
-void HTiling::setCurrentCluster(int row, int col, int offset)
-{
-    m_currentRow1 = row;
-    m_currentRow2 = min(m_rows - 1, row + offset - 1);
-    m_currentCol1 = col;
-    m_currentCol2 = min(m_columns - 1, col + offset - 1);
-}
-
 int HTiling::getHWidth(int level)
 {
     int result;
@@ -220,23 +293,100 @@ int HTiling::getHHeight(int level)
     return result;
 }
 
-bool HTiling::nodeInCurrentCluster(const AbsTilingNodeInfo& nodeInfo) const
+//--------------------------------------------------------------------------
+// building hierarchy
+
+/** Searches the edges of the clusters of one level.
+    Each thread uses its own search engines and statistics. The edges are
+    stored per cluster and added in the order of the clusters, so the
+    graph does not depend on the number of threads.
+*/
+class HTiling::HEdgesTask
+    : public ThreadPool::Task
 {
-    int nodeRow = nodeInfo.getCenterRow();
-    int nodeCol = nodeInfo.getCenterCol();
-    if (nodeRow < m_currentRow1 || nodeRow > m_currentRow2)
-    {
-        return false;
-    }
-    if (nodeCol < m_currentCol1 || nodeCol > m_currentCol2)
+public:
+    HEdgesTask(HTiling& tiling, int level, int numberThreads);
+
+    ~HEdgesTask();
+
+    /** Add the edges of all clusters to the tiling. */
+    void addEdges();
+
+    /** Add the statistics of all threads. */
+    void addStatistics(StatisticsCollection& statistics) const;
+
+    void run(int item, int thread);
+
+private:
+    HTiling& m_tiling;
+
+    int m_level;
+
+    vector<StatisticsCollection> m_statistics;
+
+    vector<SearchPool*> m_searchPools;
+
+    /** Edges found in each cluster. */
+    vector<vector<HEdge> > m_edges;
+};
+
+HTiling::HEdgesTask::HEdgesTask(HTiling& tiling, int level,
+                                int numberThreads)
+    : m_tiling(tiling),
+      m_level(level),
+      m_statistics(numberThreads, tiling.m_preStatistics[level - 1]),
+      m_edges(tiling.getHWidth(level)*tiling.getHHeight(level))
+{
+    for (int i = 0; i < numberThreads; ++i)
     {
-        return false;
+        m_statistics[i].clear();
+        m_searchPools.push_back(new SearchPool());
     }
-    return true;
 }
 
-//--------------------------------------------------------------------------
-// building hierarchy
+HTiling::HEdgesTask::~HEdgesTask()
+{
+    for (vector<SearchPool*>::iterator i = m_searchPools.begin();
+         i != m_searchPools.end(); ++i)
+        delete *i;
+}
+
+void HTiling::HEdgesTask::addEdges()
+{
+    Statistics& intraEdges =
+        m_tiling.m_storageStatistics[m_level].get("intra_edges");
+    for (vector<vector<HEdge> >::const_iterator i = m_edges.begin();
+         i != m_edges.end(); ++i)
+        for (vector<HEdge>::const_iterator j = i->begin(); j != i->end();
+             ++j)
+        {
+            m_tiling.addOutEdge(j->m_node1, j->m_node2, j->m_cost, m_level,
+                                false);
+            m_tiling.addOutEdge(j->m_node2, j->m_node1, j->m_cost, m_level,
+                                false);
+            intraEdges.add(1);
+        }
+}
+
+void HTiling::HEdgesTask::addStatistics(StatisticsCollection& statistics)
+    const
+{
+    for (vector<StatisticsCollection>::const_iterator i =
+             m_statistics.begin(); i != m_statistics.end(); ++i)
+        statistics.add(*i);
+}
+
+void HTiling::HEdgesTask::run(int item, int thread)
+{
+    int offset = m_tiling.getOffset(m_level);
+    int width = m_tiling.getHWidth(m_level);
+    SearchContext context(m_tiling);
+    context.setLevel(m_level - 1);
+    context.setCluster((item/width)*offset, (item%width)*offset, offset);
+    SearchPool::Lease search(*m_searchPools[thread]);
+    m_tiling.findClusterHEdges(context, m_level, *search,
+                               m_statistics[thread], m_edges[item]);
+}
 
 void HTiling::createHEdges()
 {
@@ -244,125 +394,76 @@ void HTiling::createHEdges()
     for (int level = 2; level <= m_maxLevel; level++)
     {
         cerr << " level " << level << "...";
-        int offset = getOffset(level);
-        m_currentLevel = level - 1;
-        // for each cluster
-        for (int row = 0; row < m_rows; row += offset)
-        for (int col = 0; col < m_columns; col += offset)
-        {
-            setCurrentCluster(row, col, offset);
-            // combine nodes on vertical edges:
-            for (int i1 = m_currentRow1; i1 <= m_currentRow2; i1++)
-                for (int j1 = m_currentCol1; j1 <= m_currentCol2; j1 += (m_currentCol2 - m_currentCol1))
-            {
-                if (m_absNodeIds[i1*m_columns+j1] == NO_NODE)
-                    continue;
-                const AbsTilingNodeInfo& nodeInfo1 = m_graph.getNodeInfo(m_absNodeIds[i1*m_columns+j1]);
-                if (nodeInfo1.getLevel() < level)
-                    continue;
-                for (int i2 = m_currentRow1; i2 <= m_currentRow2; i2++)
-                for (int j2 = m_currentCol1; j2 <= m_currentCol2; j2 += (m_currentCol2 - m_currentCol1))
-                {
-                    if (i1*m_columns+j1 >= i2*m_columns+j2)
-                        continue;
-                    if (m_absNodeIds[i2*m_columns+j2] == NO_NODE)
-                        continue;
-                    const AbsTilingNodeInfo& nodeInfo2 = m_graph.getNodeInfo(m_absNodeIds[i2*m_columns+j2]);
-                    if (nodeInfo2.getLevel() < level)
-                        continue;
-                    {
-                        AStar search(false);
-                        search.findPath(*this, m_absNodeIds[i1*m_columns+j1], m_absNodeIds[i2*m_columns+j2]);
-                        const StatisticsCollection& searchStatistics = search.getStatistics();
-                        m_preStatistics[level - 1].add(searchStatistics);
-                        if (search.getPathCost() >= 0)
-                        {
-                            addOutEdge(m_absNodeIds[i1*m_columns+j1],
-                                       m_absNodeIds[i2*m_columns+j2],
-                                       search.getPathCost(), level, false);
-                            addOutEdge(m_absNodeIds[i2*m_columns+j2],
-                                       m_absNodeIds[i1*m_columns+j1],
-                                       search.getPathCost(), level, false);
-                            m_storageStatistics[level].get("intra_edges").add(1);
-                        }
-                    }
-                }
-            }
-            for (int i1 = m_currentRow1; i1 <= m_currentRow2; i1 += (m_currentRow2 - m_currentRow1))
-            for (int j1 = m_currentCol1; j1 <= m_currentCol2; j1++)
-            {
-                if (m_absNodeIds[i1*m_columns+j1] == NO_NODE)
-                    continue;
-                const AbsTilingNodeInfo& nodeInfo1 = m_graph.getNodeInfo(m_absNodeIds[i1*m_columns+j1]);
-                if (nodeInfo1.getLevel() < level)
-                    continue;
-                for (int i2 = m_currentRow1; i2 <= m_currentRow2; i2 += (m_currentRow2 - m_currentRow1))
-                for (int j2 = m_currentCol1; j2 <= m_currentCol2; j2++)
-                {
-                    if (i1*m_columns+j1 >= i2*m_columns+j2)
-                        continue;
-                    if (m_absNodeIds[i2*m_columns+j2] == NO_NODE)
-                        continue;
-                    const AbsTilingNodeInfo& nodeInfo2 = m_graph.getNodeInfo(m_absNodeIds[i2*m_columns+j2]);
-                    if (nodeInfo2.getLevel() < level)
-                        continue;
-                    {
-                        AStar search(false);
-                        search.findPath(*this, m_absNodeIds[i1*m_columns+j1], m_absNodeIds[i2*m_columns+j2]);
-                        const StatisticsCollection& searchStatistics = search.getStatistics();
-                        m_preStatistics[level - 1].add(searchStatistics);
-                        if (search.getPathCost() >= 0)
-                        {
-                            addOutEdge(m_absNodeIds[i1*m_columns+j1],
-                                       m_absNodeIds[i2*m_columns+j2],
-                                       search.getPathCost(), level, false);
-                            addOutEdge(m_absNodeIds[i2*m_columns+j2],
-                                       m_absNodeIds[i1*m_columns+j1],
-                                       search.getPathCost(), level, false);
-                            m_storageStatistics[level].get("intra_edges").add(1);
-                        }
-                    }
-                }
-            }
-            for (int i1 = m_currentRow1; i1 <= m_currentRow2; i1 += (m_currentRow2 - m_currentRow1))
-            for (int j1 = m_currentCol1 + 1; j1 < m_currentCol2; j1++)
-            {
-                if (m_absNodeIds[i1*m_columns+j1] == NO_NODE)
-                    continue;
-                const AbsTilingNodeInfo& nodeInfo1 = m_graph.getNodeInfo(m_absNodeIds[i1*m_columns+j1]);
-                if (nodeInfo1.getLevel() < level)
-                    continue;
-                for (int i2 = m_currentRow1 + 1; i2 < m_currentRow2; i2++)
-                for (int j2 = m_currentCol1; j2 <= m_currentCol2; j2 += (m_currentCol2 - m_currentCol1))
-                {
-                    if (m_absNodeIds[i2*m_columns+j2] == NO_NODE)
-                        continue;
-                    const AbsTilingNodeInfo& nodeInfo2 = m_graph.getNodeInfo(m_absNodeIds[i2*m_columns+j2]);
-                    if (nodeInfo2.getLevel() < level)
-                        continue;
-                    {
-                        AStar search(false);
-                        search.findPath(*this, m_absNodeIds[i1*m_columns+j1], m_absNodeIds[i2*m_columns+j2]);
-                        const StatisticsCollection& searchStatistics = search.getStatistics();
-                        m_preStatistics[level - 1].add(searchStatistics);
-                        if (search.getPathCost() >= 0)
-                        {
-                            addOutEdge(m_absNodeIds[i1*m_columns+j1],
-                                       m_absNodeIds[i2*m_columns+j2],
-                                       search.getPathCost(), level, false);
-                            addOutEdge(m_absNodeIds[i2*m_columns+j2],
-                                       m_absNodeIds[i1*m_columns+j1],
-                                       search.getPathCost(), level, false);
-                            m_storageStatistics[level].get("intra_edges").add(1);
-                        }
-                    }
-                }
-            }
-        }
+        HEdgesTask task(*this, level, m_threadPool.getNumberThreads());
+        m_threadPool.run(task, getHWidth(level)*getHHeight(level));
+        task.addStatistics(m_preStatistics[level - 1]);
+        task.addEdges();
     }
     cerr << "\n";
 }
 
+void HTiling::findClusterHEdges(const SearchContext& context, int level,
+                                AStar& search,
+                                StatisticsCollection& statistics,
+                                vector<HEdge>& edges) const
+{
+    int row1 = context.getRow1();
+    int row2 = context.getRow2();
+    int col1 = context.getCol1();
+    int col2 = context.getCol2();
+    // combine nodes on vertical edges:
+    for (int i1 = row1; i1 <= row2; i1++)
+    for (int j1 = col1; j1 <= col2; j1 += (col2 - col1))
+    for (int i2 = row1; i2 <= row2; i2++)
+    for (int j2 = col1; j2 <= col2; j2 += (col2 - col1))
+    {
+        if (i1*m_columns+j1 >= i2*m_columns+j2)
+            continue;
+        findHEdge(context, level, i1, j1, i2, j2, search, statistics, edges);
+    }
+    for (int i1 = row1; i1 <= row2; i1 += (row2 - row1))
+    for (int j1 = col1; j1 <= col2; j1++)
+    for (int i2 = row1; i2 <= row2; i2 += (row2 - row1))
+    for (int j2 = col1; j2 <= col2; j2++)
+    {
+        if (i1*m_columns+j1 >= i2*m_columns+j2)
+            continue;
+        findHEdge(context, level, i1, j1, i2, j2, search, statistics, edges);
+    }
+    for (int i1 = row1; i1 <= row2; i1 += (row2 - row1))
+    for (int j1 = col1 + 1; j1 < col2; j1++)
+    for (int i2 = row1 + 1; i2 < row2; i2++)
+    for (int j2 = col1; j2 <= col2; j2 += (col2 - col1))
+        findHEdge(context, level, i1, j1, i2, j2, search, statistics, edges);
+}
+
+void HTiling::findHEdge(const SearchContext& context, int level, int i1,
+                        int j1, int i2, int j2, AStar& search,
+                        StatisticsCollection& statistics,
+                        vector<HEdge>& edges) const
+{
+    int node1Id = m_absNodeIds[i1*m_columns+j1];
+    if (node1Id == NO_NODE)
+        return;
+    if (m_graph.getNodeInfo(node1Id).getLevel() < level)
+        return;
+    int node2Id = m_absNodeIds[i2*m_columns+j2];
+    if (node2Id == NO_NODE)
+        return;
+    if (m_graph.getNodeInfo(node2Id).getLevel() < level)
+        return;
+    search.findPath(context, node1Id, node2Id);
+    statistics.add(search.getStatistics());
+    if (search.getPathCost() >= 0)
+    {
+        HEdge edge;
+        edge.m_node1 = node1Id;
+        edge.m_node2 = node2Id;
+        edge.m_cost = search.getPathCost();
+        edges.push_back(edge);
+    }
+}
+
 void HTiling::createGraph()
 {
     createNodes();
@@ -373,77 +474,153 @@ void HTiling::createGraph()
 //-----------------------------------------------------------------------------
 
 // hierarchical search
-void HTiling::doSearch(int startNodeId, int targetNodeId, int level, 
-                       vector<int>& result, bool mainSearch)
+HTiling::HierarchicalSearch::HierarchicalSearch(HTiling& tiling)
+    : m_tiling(tiling),
+      m_context(tiling),
+      m_search(0),
+      m_isMainSearch(false),
+      m_searchLevel(0),
+      m_level(0),
+      m_segment(0)
 {
-    auto_ptr<AStar> search;
-    search.reset(new AStar(mainSearch));
-    m_currentLevel = level;
-    const AbsTilingNodeInfo& nodeInfo = m_graph.getNodeInfo(startNodeId);
-    if (mainSearch)
-    {
-        setCurrentCluster(nodeInfo.getCenterId(), m_maxLevel + 1);
-    }
-    else
-        setCurrentCluster(nodeInfo.getCenterId(), level + 1);
-    search->findPath(*this, startNodeId, targetNodeId);
-    const StatisticsCollection& searchStatistics = search->getStatistics();
-    if (mainSearch)
-    {
-        m_abMainSearchStatistics[level].add(searchStatistics);
-    }
-    else
-        m_abInterSearchStatistics[level].add(searchStatistics);
-    if (search->getPathCost() == -1)
-    {
-        cerr << "oops, no path found\n";
-        assert (false);
-    }
-    else
-    {
-        result = search->getPath();
-//         cerr << "path: ";
-//         for (int i = 0; i < result.size(); i++)
-//             cerr << result[i] << " ";
-//         cerr << "\n";
-        reverse(result.begin(), result.end());
-    }
 }
 
-void HTiling::doHierarchicalSearch(int startNodeId, int targetNodeId, vector<int>& result, int maxSearchLevel)
+HTiling::HierarchicalSearch::~HierarchicalSearch()
 {
-    vector<int> tmppath, path;
-    doSearch(startNodeId, targetNodeId, maxSearchLevel, path, true);
-    for (int level = maxSearchLevel; level > 1; level--)
-    {
-        refineAbsPath(path, level, tmppath);
-        path = tmppath;
-    }
-    result = path;
+    cancel();
 }
 
-void HTiling::refineAbsPath(vector<int>& path, int level, vector<int>& result)
+void HTiling::HierarchicalSearch::begin(int startNodeId, int targetNodeId,
+                                        int maxSearchLevel,
+                                        double suboptimalityBound,
+                                        AStar::SuboptimalMode suboptimalMode)
 {
-    result.clear();
-    vector<int> tmp;
-    // add first elem
-    result.push_back(path[0]);
+    cancel();
+    m_path.clear();
+    m_refinedPath.clear();
+    m_search = &m_tiling.m_searchPool.acquire();
+    m_search->setSuboptimalityBound(suboptimalityBound, suboptimalMode);
+    beginSearch(startNodeId, targetNodeId, maxSearchLevel, true);
+}
 
-    for (unsigned int i = 0; i < path.size() - 1; i++)
+bool HTiling::HierarchicalSearch::beginNextRefinement()
+{
+    while (m_level > 1)
     {
-        if (sameCluster(path[i], path[i+1], level))
+        int numberSegments = m_path.size() - 1;
+        for (++m_segment; m_segment < numberSegments; ++m_segment)
         {
-            doSearch(path[i], path[i+1], level - 1, tmp, false);
-            for (unsigned int k = 0; k < tmp.size(); k++)
+            int start = m_path[m_segment];
+            int target = m_path[m_segment + 1];
+            if (m_tiling.sameCluster(start, target, m_level))
             {
-                if (result[result.size() - 1] != tmp[k])
-                    result.push_back(tmp[k]);
+                beginSearch(start, target, m_level - 1, false);
+                return true;
             }
         }
+        // make sure last elem is added
+        if (m_refinedPath.back() != m_path.back())
+            m_refinedPath.push_back(m_path.back());
+        m_path.swap(m_refinedPath);
+        --m_level;
+        m_segment = -1;
+        m_refinedPath.assign(1, m_path[0]);
     }
-    // make sure last elem is added
-    if (result[result.size() - 1] != path[path.size() - 1])
-        result.push_back(path[path.size() - 1]);
+    return false;
+}
+
+void HTiling::HierarchicalSearch::beginSearch(int startNodeId,
+                                              int targetNodeId, int level,
+                                              bool isMainSearch)
+{
+    m_isMainSearch = isMainSearch;
+    m_searchLevel = level;
+    m_context.setSearch(startNodeId, level, isMainSearch);
+    m_search->begin(m_context, startNodeId, targetNodeId);
+}
+
+void HTiling::HierarchicalSearch::cancel()
+{
+    if (m_search == 0)
+        return;
+    m_search->cancel();
+    release();
+}
+
+void HTiling::HierarchicalSearch::release()
+{
+    m_tiling.m_searchPool.release(*m_search);
+    m_search = 0;
+}
+
+AStar::StepResult HTiling::HierarchicalSearch::step(long long int
+                                                    maxExpansions)
+{
+    assert(m_search != 0);
+    while (true)
+    {
+        long long int nodesExpanded = m_search->getNodesExpanded();
+        AStar::StepResult result = m_search->step(maxExpansions);
+        if (result == AStar::STEP_IN_PROGRESS)
+            return result;
+        if (maxExpansions >= 0)
+            maxExpansions -= m_search->getNodesExpanded() - nodesExpanded;
+        const StatisticsCollection& searchStatistics =
+            m_search->getStatistics();
+        if (m_isMainSearch)
+            m_tiling.m_abMainSearchStatistics[m_searchLevel].add(
+                                                         searchStatistics);
+        else
+            m_tiling.m_abInterSearchStatistics[m_searchLevel].add(
+                                                         searchStatistics);
+        if (result == AStar::STEP_FAILED)
+        {
+            release();
+            return result;
+        }
+        const vector<int>& path = m_search->getPath();
+        if (m_isMainSearch)
+        {
+            m_path.assign(path.rbegin(), path.rend());
+            m_level = m_searchLevel;
+            m_segment = -1;
+            m_refinedPath.assign(1, m_path[0]);
+            // The refinement searches are optimal
+            m_search->setSuboptimalityBound(1);
+        }
+        else
+        {
+            for (vector<int>::const_reverse_iterator i = path.rbegin();
+                 i != path.rend(); ++i)
+                if (m_refinedPath.back() != *i)
+                    m_refinedPath.push_back(*i);
+        }
+        if (! beginNextRefinement())
+        {
+            release();
+            return AStar::STEP_FOUND;
+        }
+        if (maxExpansions == 0)
+            return AStar::STEP_IN_PROGRESS;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void HTiling::doHierarchicalSearch(int startNodeId, int targetNodeId, vector<int>& result, int maxSearchLevel,
+                                   double suboptimalityBound,
+                                   AStar::SuboptimalMode suboptimalMode)
+{
+    HierarchicalSearch search(*this);
+    search.begin(startNodeId, targetNodeId, maxSearchLevel,
+                 suboptimalityBound, suboptimalMode);
+    if (search.step(-1) == AStar::STEP_FAILED)
+    {
+        cerr << "oops, no path found\n";
+        assert (false);
+        return;
+    }
+    result = search.getPath();
 }
 
 void HTiling::printGraph(ostream& o)
@@ -464,13 +641,3 @@ void HTiling::printGraph(ostream& o)
         o << "\n";
     }
 }
-
-bool HTiling::pruneNode(int targetNodeId, int nodeId, int lastNodeId) const
-{
-    // if target node is in the same cluster as last node
-    if (sameCluster(targetNodeId, lastNodeId, m_currentLevel))
-    {
-        return true;
-    }
-    return false;
-}
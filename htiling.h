@@ -28,6 +28,200 @@ namespace PathFind
         : public AbsTiling
     {
     public:
+        class HierarchicalSearch;
+
+        class SearchContext;
+
+        friend class HierarchicalSearch;
+
+        friend class SearchContext;
+
+        /** Abstract graph restricted to one level and one cluster.
+            Used as the environment of the searches on the tiling, so
+            that searches with different restrictions can run at the
+            same time.
+        */
+        class SearchContext
+            : public Environment
+        {
+        public:
+            /** Constructor.
+                The context is restricted to level 1 and the whole map.
+            */
+            explicit SearchContext(const HTiling& tiling);
+
+            int getRow1() const
+            {
+                return m_row1;
+            }
+
+            int getRow2() const
+            {
+                return m_row2;
+            }
+
+            int getCol1() const
+            {
+                return m_col1;
+            }
+
+            int getCol2() const
+            {
+                return m_col2;
+            }
+
+            /** Restrict the search to the edges of a level. */
+            void setLevel(int level)
+            {
+                m_level = level;
+            }
+
+            /** Restrict the search to the cluster of a level that
+                contains a low-level node.
+                @param nodeId Low-level node.
+                @param level Level of the cluster, the whole map if
+                larger than the maximum level.
+            */
+            void setCluster(int nodeId, int level);
+
+            /** Restrict the search to the cluster with a given upper
+                left corner and size.
+            */
+            void setCluster(int row, int col, int offset);
+
+            /** Set the level and cluster for a search.
+                @param mainSearch Whether the search is the main search of
+                a hierarchical search, which is not restricted to a
+                cluster.
+            */
+            void setSearch(int startNodeId, int level, bool mainSearch);
+
+            int getHeuristic(int start, int target) const;
+
+            int getMaxCost() const;
+
+            int getMinCost() const;
+
+            int getNumberNodes() const;
+
+            void getSuccessors(int nodeId, int lastNodeId,
+                               vector<Successor>& result) const;
+
+            void visitSuccessors(int nodeId, int lastNodeId,
+                                 SuccessorVisitor& visitor) const;
+
+            bool isValidNodeId(int nodeId) const;
+
+        private:
+            const HTiling& m_tiling;
+
+            int m_level;
+
+            int m_row1;
+
+            int m_row2;
+
+            int m_col1;
+
+            int m_col2;
+
+            bool isInCluster(const AbsTilingNodeInfo& nodeInfo) const;
+        };
+
+        /** Hierarchical search that is run in steps with a limited
+            number of node expansions.
+            First searches the abstract path at the highest level (main
+            search), then refines it level by level with a search for
+            each pair of consecutive nodes in the same cluster. All
+            searches use one engine from the search pool of the tiling,
+            which is returned when the search is finished or cancelled.
+            Other searches can use the tiling between calls to step(),
+            but the abstract graph must not change.
+        */
+        class HierarchicalSearch
+        {
+        public:
+            explicit HierarchicalSearch(HTiling& tiling);
+
+            /** Cancels the search if it is not finished. */
+            ~HierarchicalSearch();
+
+            /** Start a search, see HTiling::doHierarchicalSearch.
+                A search started before that was not finished is
+                cancelled.
+            */
+            void begin(int startNodeId, int targetNodeId,
+                       int maxSearchLevel, double suboptimalityBound = 1,
+                       AStar::SuboptimalMode suboptimalMode
+                       = AStar::SUBOPTIMAL_WEIGHTED);
+
+            /** Stop the search and return the engine to the pool.
+                Does nothing if the search is already finished.
+            */
+            void cancel();
+
+            /** Path at level 1 from start to target.
+                Only valid after step() returned AStar::STEP_FOUND.
+            */
+            const vector<int>& getPath() const
+            {
+                return m_path;
+            }
+
+            /** Continue the search.
+                The statistics of each finished search are added to the
+                main search or intermediate search statistics of the
+                tiling.
+                @param maxExpansions Maximum number of nodes expanded in
+                this call by all searches, -1 for no limit.
+            */
+            AStar::StepResult step(long long int maxExpansions);
+
+        private:
+            HTiling& m_tiling;
+
+            SearchContext m_context;
+
+            /** Engine from the pool, 0 if no search is running. */
+            AStar* m_search;
+
+            bool m_isMainSearch;
+
+            /** Level of the current search. */
+            int m_searchLevel;
+
+            /** Level of m_path. */
+            int m_level;
+
+            /** Index in m_path of the start of the current refinement
+                search.
+            */
+            int m_segment;
+
+            vector<int> m_path;
+
+            /** Refinement of m_path at level m_level - 1. */
+            vector<int> m_refinedPath;
+
+            /** Start the refinement search for the next pair of nodes in
+                m_path in the same cluster, continuing with the next level
+                if the current one is refined.
+                @return false, if the path is refined down to level 1.
+            */
+            bool beginNextRefinement();
+
+            void beginSearch(int startNodeId, int targetNodeId, int level,
+                             bool isMainSearch);
+
+            /** Return the engine to the pool. */
+            void release();
+
+            /** Not implemented. */
+            HierarchicalSearch(const HierarchicalSearch&);
+
+            /** Not implemented. */
+            HierarchicalSearch& operator=(const HierarchicalSearch&);
+        };
 
         HTiling(int clusterSize, int maxLevel, int rows, int columns);
 
@@ -35,9 +229,6 @@ namespace PathFind
 
         HTiling();
 
-        void getSuccessors(int nodeId, int lastNodeId,
-                           vector<Successor>& result) const;
-
         void printSuccTime();
 
         void insertStalHEdges(int nodeId, int nodeRow, int nodeCol);
@@ -48,49 +239,76 @@ namespace PathFind
 
         void createGraph();
 
-        void doHierarchicalSearch(int startNodeId, int targetNodeId, vector<int>& result, int maxSearchLevel);
+        /** Search a path in the abstract graph and refine it down to
+            level 1.
+            Runs a HierarchicalSearch without expansion limit.
+            @param suboptimalityBound Suboptimality bound for the main
+            search at maxSearchLevel, the refinement searches are optimal.
+            @param suboptimalMode Search used for a bound larger than 1.
+            @see AStar::setSuboptimalityBound
+        */
+        void doHierarchicalSearch(int startNodeId, int targetNodeId, vector<int>& result, int maxSearchLevel,
+                                  double suboptimalityBound = 1,
+                                  AStar::SuboptimalMode suboptimalMode
+                                  = AStar::SUBOPTIMAL_WEIGHTED);
 
         void clearStatistics();
 
     protected:
 
-        int m_currentLevel;
-
-        int m_currentRow1;
-
-        int m_currentRow2;
-
-        int m_currentCol1;
-
-        int m_currentCol2;
-
         //        double m_succTime;
 
-        bool nodeInCurrentCluster(const AbsTilingNodeInfo& nodeInfo) const;
-
-        bool pruneNode(int targetNodeId, int nodeId, int lastNodeId) const;
-
         int getOffset(int level) const
         {
             return m_clusterSize*(1 << (level - 1));
         }
 
-        void setCurrentCluster(int nodeId, int level);
-
-        void setCurrentCluster(int row, int col, int offset);
-
         int getHWidth(int level);
 
         int getHHeight(int level);
 
         bool sameCluster(int node1Id, int node2Id, int level) const;
 
-        void doSearch(int startNodeId, int targetNodeId, int level, 
-                      vector<int>& result, bool useTT);
+        /** Add the edges between the nodes of each cluster above level 1.
+            The clusters of a level are searched concurrently on the
+            thread pool, their edges are added after all searches of the
+            level are finished.
+        */
+        void createHEdges();
 
-        void refineAbsPath(vector<int>& path, int level, vector<int>& result);
+    private:
+        class HEdgesTask;
 
-        void createHEdges();
+        friend class HEdgesTask;
+
+        /** Edge found between two nodes of a cluster. */
+        struct HEdge
+        {
+            int m_node1;
+
+            int m_node2;
+
+            int m_cost;
+        };
+
+        /** Search the edges of a level between the nodes on the border
+            of a cluster.
+            Does not modify the tiling.
+            @param context Context restricted to the cluster and the
+            level below.
+        */
+        void findClusterHEdges(const SearchContext& context, int level,
+                               AStar& search,
+                               StatisticsCollection& statistics,
+                               vector<HEdge>& edges) const;
+
+        /** Search the edge between two nodes of a cluster, if both are
+            on the level.
+        */
+        void findHEdge(const SearchContext& context, int level, int i1,
+                       int j1, int i2, int j2, AStar& search,
+                       StatisticsCollection& statistics,
+                       vector<HEdge>& edges) const;
     
     };
 
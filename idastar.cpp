@@ -9,10 +9,10 @@
 
 #include "idastar.h"
 
-#include <iostream>
-#include <math.h>
+#include <algorithm>
 #include <assert.h>
-#include "util.h"
+#include <limits.h>
+#include <time.h>
 
 using namespace std;
 using namespace PathFind;
@@ -20,8 +20,21 @@ using namespace PathFind;
 //-----------------------------------------------------------------------------
 
 IDAStar::IDAStar()
-    : m_statistics(createStatistics()),
-      m_branchingFactor(m_statistics.get("branching_factor"))
+    : m_useFCache(true),
+      m_numberNodes(0),
+      m_maxTranspositionEntries(DEFAULT_TRANSPOSITION_TABLE_SIZE),
+      m_transpositionCutoffs(0),
+      m_stamp(0),
+      m_searchStamp(0),
+      m_statistics(createStatistics()),
+      m_branchingFactor(m_statistics.get("branching_factor")),
+      m_abortedStatistics(m_statistics.get("aborted")),
+      m_cpuTimeStatistics(m_statistics.get("cpu_time")),
+      m_nodesExpandedStatistics(m_statistics.get("nodes_expanded")),
+      m_nodesVisitedStatistics(m_statistics.get("nodes_visited")),
+      m_pathCostStatistics(m_statistics.get("path_cost")),
+      m_transpositionCutoffsStatistics(
+                                m_statistics.get("transposition_cutoffs"))
 {
 }
 
@@ -34,6 +47,7 @@ StatisticsCollection IDAStar::createStatistics()
     collection.create("branching_factor");
     collection.create("nodes_expanded");
     collection.create("nodes_visited");
+    collection.create("transposition_cutoffs");
     return collection;
 }
 
@@ -45,44 +59,51 @@ bool IDAStar::findPath(const Environment& env, int start, int target)
     m_statistics.clear();
     m_nodesExpanded = 0;
     m_nodesVisited = 0;
+    m_transpositionCutoffs = 0;
     m_env = &env;
     m_target = target;
     m_path.clear();
     m_abortSearch = false;
-    m_visitedNodes.resize(env.getNumberNodes());
-    for (vector<char>::iterator i = m_visitedNodes.begin();
-         i != m_visitedNodes.end(); ++i)
-        *i = ' ';
+    m_numberNodes = env.getNumberNodes();
+    clearTrace();
+    if (isTracing())
+    {
+        m_visited.init(m_numberNodes);
+        m_labels.resize(m_numberNodes);
+    }
+    initTranspositions();
     findPathIdaStar(start);
-    m_statistics.get("aborted").add(m_abortSearch ? 1 : 0);
+    m_abortedStatistics.add(m_abortSearch ? 1 : 0);
     double timeDiff =
         static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
-    m_statistics.get("cpu_time").add(timeDiff);
-    m_statistics.get("nodes_expanded").add(m_nodesExpanded);
-    m_statistics.get("nodes_visited").add(m_nodesVisited);
-    return true;
+    m_cpuTimeStatistics.add(timeDiff);
+    m_nodesExpandedStatistics.add(m_nodesExpanded);
+    m_nodesVisitedStatistics.add(m_nodesVisited);
+    m_transpositionCutoffsStatistics.add(m_transpositionCutoffs);
+    return ! m_abortSearch;
 }
 
 void IDAStar::findPathIdaStar(int start)
 {
     // if we traverse every node at max cost, what is the total cost?
-    const int maxFLimit = m_env->getNumberNodes() * m_env->getMaxCost();
+    const long long int maxFLimit =
+        static_cast<long long int>(m_numberNodes) * m_env->getMaxCost();
     int heuristic = m_env->getHeuristic(start, m_target);
     m_fLimit = heuristic;
-    int minCost = m_env->getMinCost();
-    unsigned int expectedMaxDepth =
-        static_cast<unsigned int>(heuristic / minCost);
-    if (m_successorStack.size() < expectedMaxDepth)
-        m_successorStack.resize(expectedMaxDepth);
+    m_searchStamp = m_stamp + 1;
     int iteration = 0;
     while (true)
     {
-        cerr << "limit = " << m_fLimit << '\n';
+        nextStamp();
         m_nextFLimit = INT_MAX;
-        searchPathIdaStar(iteration, start, NO_NODE, 0, 0);
+        int cutoff;
+        searchPathIdaStar(iteration, start, NO_NODE, 0, 0, cutoff);
         // We found a path! We're done.
         if (m_path.size() > 0)
             break;
+        if (m_abortSearch)
+            break;
+        // Also if no node was pruned by the threshold
         if (m_nextFLimit > maxFLimit)
             break;
         m_fLimit = m_nextFLimit;
@@ -95,20 +116,61 @@ const StatisticsCollection& IDAStar::getStatistics() const
     return m_statistics;
 }
 
+const vector<char>& IDAStar::getVisitedNodes() const
+{
+    m_visitedNodes.assign(m_numberNodes, ' ');
+    const vector<int>& visitedNodeIds = getVisitedNodeIds();
+    for (vector<int>::const_iterator i = visitedNodeIds.begin();
+         i != visitedNodeIds.end(); ++i)
+        m_visitedNodes[*i] = m_labels[*i];
+    return m_visitedNodes;
+}
+
+void IDAStar::initTranspositions()
+{
+    int size = min(m_maxTranspositionEntries, m_numberNodes);
+    if (static_cast<int>(m_transpositions.size()) == size)
+        return;
+    TranspositionEntry empty;
+    empty.m_nodeId = NO_NODE;
+    empty.m_stamp = 0;
+    empty.m_g = 0;
+    empty.m_f = 0;
+    m_transpositions.assign(size, empty);
+    m_stamp = 0;
+}
+
+void IDAStar::nextStamp()
+{
+    ++m_stamp;
+    if (m_stamp == 0)
+    {
+        // Wrapped around, forget the entries of all iterations
+        for (vector<TranspositionEntry>::iterator i =
+                 m_transpositions.begin(); i != m_transpositions.end(); ++i)
+            i->m_stamp = 0;
+        m_stamp = 1;
+        m_searchStamp = 1;
+    }
+}
+
 bool IDAStar::searchPathIdaStar(int iteration, int node, int lastNode,
-                                int depth, int g)
+                                int depth, int g, int& cutoff)
 {
+    cutoff = INT_MAX;
     ++m_nodesVisited;
-    char label;
-    if (m_visitedNodes[node] == ' ')
+    if (isTracing() && ! m_visited.isMarked(node))
     {
+        char label;
         if (iteration < 10)
             label = '0' + iteration;
         else if (iteration <= 36)
             label = 'a' + iteration - 10;
         else
             label = '+';
-        m_visitedNodes[node] = label;
+        m_visited.mark(node);
+        m_labels[node] = label;
+        traceVisited(node);
     }
     if (m_nodesLimit >= 0 && m_nodesVisited > m_nodesLimit)
     {
@@ -116,46 +178,114 @@ bool IDAStar::searchPathIdaStar(int iteration, int node, int lastNode,
         return false;
     }
     int f = g + m_env->getHeuristic(node, m_target);
+    TranspositionEntry* entry = 0;
+    if (! m_transpositions.empty())
+    {
+        entry = &m_transpositions[node % m_transpositions.size()];
+        if (entry->m_nodeId == node && entry->m_stamp >= m_searchStamp
+            && entry->m_g <= g)
+        {
+            if (entry->m_stamp == m_stamp)
+            {
+                // Searched in this iteration or on the current path
+                ++m_transpositionCutoffs;
+                return false;
+            }
+            if (m_useFCache)
+            {
+                if (entry->m_f == INT_MAX)
+                {
+                    // No path below this node
+                    ++m_transpositionCutoffs;
+                    return false;
+                }
+                f = max(f, g + (entry->m_f - entry->m_g));
+            }
+        }
+    }
     if (f > m_fLimit)
     {
         if (f < m_nextFLimit)
         {
             m_nextFLimit = f;
         }
+        cutoff = f;
         return false;
     }
     if (node == m_target)
     {
-        m_statistics.get("path_cost").add(f);
+        m_pathCostStatistics.add(f);
         m_path.push_back(node);
         return true;
     }
     ++m_nodesExpanded;
     assert(depth >= 0);
-    if (m_successorStack.size() < static_cast<unsigned int>(depth + 1))
-        m_successorStack.resize(depth + 1);
-    vector<Environment::Successor>& successors = m_successorStack[depth];
-    m_env->getSuccessors(node, lastNode, successors);
-    int numberSuccessors = successors.size();
-    m_branchingFactor.add(numberSuccessors);
-    //    cout << "Generated " << numberSuccessors << " successors\n";
-    for (int i = 0; i < numberSuccessors; ++i)
+    if (entry != 0)
     {
-        // Get reference on edge again, because resize could have changed it.
-        const Environment::Successor& successor = m_successorStack[depth][i];
-        int targetNodeId = successor.m_target;
-        if (targetNodeId == lastNode)
-            continue;
-        if (searchPathIdaStar(iteration, targetNodeId, node, depth + 1,
-                              g + successor.m_cost))
-        {
-            m_path.push_back(node);
-            return true;
-        }
-        if (m_abortSearch)
-            return false;
+        entry->m_nodeId = node;
+        entry->m_stamp = m_stamp;
+        entry->m_g = g;
+        entry->m_f = f;
+    }
+    SuccessorSearch successorSearch(*this, iteration, node, lastNode, depth,
+                                    g);
+    m_env->visitSuccessors(node, lastNode, successorSearch);
+    if (SAMPLE_EXPANSIONS)
+        m_branchingFactor.add(successorSearch.getNumberSuccessors());
+    if (successorSearch.isPathFound())
+    {
+        m_path.push_back(node);
+        return true;
+    }
+    cutoff = successorSearch.getCutoff();
+    if (entry != 0 && ! m_abortSearch)
+    {
+        // The entry may have been replaced by a colliding node
+        entry->m_nodeId = node;
+        entry->m_stamp = m_stamp;
+        entry->m_g = g;
+        entry->m_f = cutoff;
     }
     return false;
 }
 
+void IDAStar::setTranspositionTableSize(int maxEntries)
+{
+    assert(maxEntries >= 0);
+    m_maxTranspositionEntries = maxEntries;
+}
+
+//-----------------------------------------------------------------------------
+
+IDAStar::SuccessorSearch::SuccessorSearch(IDAStar& search, int iteration,
+                                          int node, int lastNode, int depth,
+                                          int g)
+    : m_search(search),
+      m_iteration(iteration),
+      m_node(node),
+      m_lastNode(lastNode),
+      m_depth(depth),
+      m_g(g),
+      m_numberSuccessors(0),
+      m_cutoff(INT_MAX),
+      m_isPathFound(false)
+{
+}
+
+bool IDAStar::SuccessorSearch::visit(int target, int cost)
+{
+    ++m_numberSuccessors;
+    if (m_isPathFound || m_search.m_abortSearch)
+        return true;
+    if (target == m_lastNode)
+        return true;
+    int cutoff;
+    if (m_search.searchPathIdaStar(m_iteration, target, m_node, m_depth + 1,
+                                   m_g + cost, cutoff))
+        m_isPathFound = true;
+    else if (cutoff < m_cutoff)
+        m_cutoff = cutoff;
+    return true;
+}
+
 //-----------------------------------------------------------------------------
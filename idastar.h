@@ -13,6 +13,18 @@
     previous iteration. The algorithm terminates when a goal state is
     reached whose total cost does not exceed the current threshold.
 
+    On graphs with many paths to the same node, like grids, plain IDA*
+    searches the same node again for each path. A transposition table
+    stores the g value of expanded nodes. A node reached again in the
+    same iteration with a g value that is not smaller is pruned, this
+    also removes cycles. The table can also store the smallest f value
+    of the nodes pruned below an expanded node (backed-up f value),
+    which is a lower bound for paths through the node in later
+    iterations.
+
+    See A. Reinefeld, T. Marsland: Enhanced Iterative-Deepening Search
+    (IEEE PAMI 1994).
+
     $Id: idastar.h,v 1.4 2002/12/09 22:10:19 emarkus Exp $
     $Source: /usr/cvsroot/project_pathfind/idastar.h,v $
 */
@@ -21,6 +33,7 @@
 #ifndef PATHFIND_IDASTAR_H
 #define PATHFIND_IDASTAR_H
 
+#include "markerarray.h"
 #include "search.h"
 
 //-----------------------------------------------------------------------------
@@ -29,14 +42,28 @@ namespace PathFind
 {
     using namespace std;
 
+    /** IDA* search engine with transposition table.
+        The transposition table is direct-mapped by node id with a
+        bounded number of entries, colliding nodes replace each other.
+        Collects the statistics aborted, cpu_time, path_cost,
+        branching_factor, nodes_expanded, nodes_visited and the number
+        of nodes pruned by the transposition table
+        (transposition_cutoffs).
+    */
     class IDAStar
         : public Search
     {
     public:
+        static const int DEFAULT_TRANSPOSITION_TABLE_SIZE = 1 << 20;
+
         IDAStar();
 
         StatisticsCollection createStatistics();
 
+        /** Find a path.
+            @return false, if search was aborted due to node limit.
+            The abort is also recorded in the aborted statistics.
+        */
         bool findPath(const Environment& env, int start, int target);
 
         const vector<int>& getPath() const
@@ -46,14 +73,56 @@ namespace PathFind
 
         const StatisticsCollection& getStatistics() const;
 
-        const vector<char>& getVisitedNodes() const
+        /** Get a vector with char labels for each visited node.
+            The label is the iteration in which the node was visited
+            first.
+            @see Search::getVisitedNodes
+        */
+        const vector<char>& getVisitedNodes() const;
+
+        /** Set the maximum number of entries of the transposition table.
+            The table has at most one entry per node of the environment.
+            0 disables the transposition table and searches like plain
+            IDA*. The default is DEFAULT_TRANSPOSITION_TABLE_SIZE.
+        */
+        void setTranspositionTableSize(int maxEntries);
+
+        /** Use backed-up f values of the transposition table.
+            Prunes nodes whose backed-up f value from a previous
+            iteration exceeds the threshold without searching below
+            them. Has no effect without transposition table. The default
+            is true.
+        */
+        void setUseFCache(bool enable)
         {
-            return m_visitedNodes;
+            m_useFCache = enable;
         }
 
     private:
+        /** Entry of the transposition table. */
+        class TranspositionEntry
+        {
+        public:
+            int m_nodeId;
+
+            /** Iteration stamp of the last update, 0 for empty entries.
+                @see IDAStar::m_stamp
+            */
+            unsigned int m_stamp;
+
+            int m_g;
+
+            /** Backed-up f value for m_g, INT_MAX if no node below the
+                node was pruned by the threshold.
+                While the node is searched, its own f value.
+            */
+            int m_f;
+        };
+
         bool m_abortSearch;
 
+        bool m_useFCache;
+
         int m_target;
 
         int m_fLimit;
@@ -66,21 +135,123 @@ namespace PathFind
 
         long long int m_nodesVisited;
 
-        vector<char> m_visitedNodes;
+        /** Number of nodes of the environment in the last search. */
+        int m_numberNodes;
 
-        vector<int> m_path;
+        int m_maxTranspositionEntries;
+
+        long long int m_transpositionCutoffs;
+
+        /** Stamp of the current iteration.
+            Incremented for each iteration over all searches.
+        */
+        unsigned int m_stamp;
+
+        /** Stamp of the first iteration of the current search. */
+        unsigned int m_searchStamp;
+
+        vector<TranspositionEntry> m_transpositions;
+
+        /** Nodes visited in the current search, only used if tracing. */
+        MarkerArray m_visited;
 
-        vector<vector<Environment::Successor> > m_successorStack;
+        /** Label by nodeId, only valid for nodes marked in m_visited. */
+        vector<char> m_labels;
+
+        mutable vector<char> m_visitedNodes;
+
+        vector<int> m_path;
 
         StatisticsCollection m_statistics;
 
         Statistics& m_branchingFactor;
 
+        Statistics& m_abortedStatistics;
+
+        Statistics& m_cpuTimeStatistics;
+
+        Statistics& m_nodesExpandedStatistics;
+
+        Statistics& m_nodesVisitedStatistics;
+
+        Statistics& m_pathCostStatistics;
+
+        Statistics& m_transpositionCutoffsStatistics;
+
+        /** Visitor that continues the depth-first search at each
+            successor of a node.
+        */
+        class SuccessorSearch;
+
+        friend class SuccessorSearch;
+
+        class SuccessorSearch
+            : public Environment::SuccessorVisitor
+        {
+        public:
+            SuccessorSearch(IDAStar& search, int iteration, int node,
+                            int lastNode, int depth, int g);
+
+            /** Smallest f value pruned by the threshold in the searches
+                from the successors.
+            */
+            int getCutoff() const
+            {
+                return m_cutoff;
+            }
+
+            int getNumberSuccessors() const
+            {
+                return m_numberSuccessors;
+            }
+
+            bool isPathFound() const
+            {
+                return m_isPathFound;
+            }
+
+            /** Search from the successor.
+                Keeps counting the remaining successors after the path
+                was found or the search was aborted, so that the
+                branching factor statistics are not affected.
+            */
+            bool visit(int target, int cost);
+
+        private:
+            IDAStar& m_search;
+
+            int m_iteration;
+
+            int m_node;
+
+            int m_lastNode;
+
+            int m_depth;
+
+            int m_g;
+
+            int m_numberSuccessors;
+
+            int m_cutoff;
+
+            bool m_isPathFound;
+        };
 
         void findPathIdaStar(int start);
 
+        /** Resize the transposition table for the current environment. */
+        void initTranspositions();
+
+        /** Start a new iteration in the transposition table. */
+        void nextStamp();
+
+        /** Depth-first search from a node.
+            @param cutoff Returns the smallest f value pruned by the
+            threshold in this search, INT_MAX if none.
+            @return true, if the path was found.
+        */
         bool searchPathIdaStar(int iteration, int node, int lastNode,
-                               int depth, int g);
+                               int depth, int g, int& cutoff);
     };
 }
 
@@ -0,0 +1,349 @@
+//-----------------------------------------------------------------------------
+/** @file jumppointsearch.cpp
+    @see jumppointsearch.h
+*/
+//-----------------------------------------------------------------------------
+
+#include "jumppointsearch.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <time.h>
+#include "error.h"
+#include "tiling.h"
+#include "tilingastar.h"
+
+using namespace std;
+using namespace PathFind;
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+    int getSign(int value)
+    {
+        if (value > 0)
+            return 1;
+        if (value < 0)
+            return -1;
+        return 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+JumpPointSearch::JumpPointSearch()
+    : m_isAborted(false),
+      m_columns(0),
+      m_rows(0),
+      m_target(NO_NODE),
+      m_targetRow(0),
+      m_targetCol(0),
+      m_pathCost(-1),
+      m_tiling(0),
+      m_originId(0),
+      m_tilingColumns(0),
+      m_nodesExpanded(0),
+      m_nodesVisited(0),
+      m_openSize(0),
+      m_statistics(createStatistics()),
+      m_branchingFactor(m_statistics.get("branching_factor")),
+      m_cpuTimeStatistics(m_statistics.get("cpu_time")),
+      m_nodesExpandedStatistics(m_statistics.get("nodes_expanded")),
+      m_nodesVisitedStatistics(m_statistics.get("nodes_visited")),
+      m_openLengthStatistics(m_statistics.get("open_length")),
+      m_openMaxStatistics(m_statistics.get("open_max")),
+      m_pathCostStatistics(m_statistics.get("path_cost")),
+      m_pathLengthStatistics(m_statistics.get("path_length"))
+{
+}
+
+inline int JumpPointSearch::getHeuristic(int nodeId) const
+{
+    int diffRow = abs(nodeId / m_columns - m_targetRow);
+    int diffCol = abs(nodeId % m_columns - m_targetCol);
+    return TilingHeuristic<Tiling::OCTILE>::getDistance(diffRow, diffCol);
+}
+
+inline bool JumpPointSearch::isBlocked(int row, int col) const
+{
+    if (row < 0 || row >= m_rows || col < 0 || col >= m_columns)
+        return true;
+    return m_tiling->isObstacle(m_originId + row * m_tilingColumns + col);
+}
+
+inline bool JumpPointSearch::canMove(int row, int col, int rowOffset,
+                                     int colOffset) const
+{
+    if (isBlocked(row + rowOffset, col + colOffset))
+        return false;
+    if (rowOffset == 0 || colOffset == 0)
+        return true;
+    // See Tiling::canJump
+    return (! isBlocked(row + rowOffset, col)
+            || ! isBlocked(row, col + colOffset));
+}
+
+//-----------------------------------------------------------------------------
+
+void JumpPointSearch::constructPath(int start)
+{
+    // Jump points from target to start
+    vector<int> jumpPoints = m_nodeStates.constructPath(start, m_target);
+    m_path.clear();
+    m_path.push_back(m_target);
+    for (vector<int>::size_type i = 1; i < jumpPoints.size(); ++i)
+    {
+        int row = jumpPoints[i - 1] / m_columns;
+        int col = jumpPoints[i - 1] % m_columns;
+        int toRow = jumpPoints[i] / m_columns;
+        int toCol = jumpPoints[i] % m_columns;
+        int rowOffset = getSign(toRow - row);
+        int colOffset = getSign(toCol - col);
+        while (row != toRow || col != toCol)
+        {
+            row += rowOffset;
+            col += colOffset;
+            m_path.push_back(row * m_columns + col);
+        }
+    }
+}
+
+StatisticsCollection JumpPointSearch::createStatistics()
+{
+    return createBasicStatistics();
+}
+
+int JumpPointSearch::expand(int nodeId, int g)
+{
+    int row = nodeId / m_columns;
+    int col = nodeId % m_columns;
+    int parent = m_nodeStates.getParent(nodeId);
+    int numberSuccessors = 0;
+    if (parent == NO_NODE)
+    {
+        // Obstacles have no successors, like in Tiling::visitSuccessors
+        if (isBlocked(row, col))
+            return 0;
+        for (int rowOffset = -1; rowOffset <= 1; ++rowOffset)
+            for (int colOffset = -1; colOffset <= 1; ++colOffset)
+                if (rowOffset != 0 || colOffset != 0)
+                    numberSuccessors += jumpAndAdd(nodeId, g, row, col,
+                                                   rowOffset, colOffset);
+        return numberSuccessors;
+    }
+    int rowOffset = getSign(row - parent / m_columns);
+    int colOffset = getSign(col - parent % m_columns);
+    if (rowOffset != 0 && colOffset != 0)
+    {
+        // Natural neighbors
+        numberSuccessors += jumpAndAdd(nodeId, g, row, col, rowOffset, 0);
+        numberSuccessors += jumpAndAdd(nodeId, g, row, col, 0, colOffset);
+        numberSuccessors += jumpAndAdd(nodeId, g, row, col, rowOffset,
+                                       colOffset);
+        // Forced neighbors
+        if (isBlocked(row, col - colOffset))
+            numberSuccessors += jumpAndAdd(nodeId, g, row, col, rowOffset,
+                                           -colOffset);
+        if (isBlocked(row - rowOffset, col))
+            numberSuccessors += jumpAndAdd(nodeId, g, row, col, -rowOffset,
+                                           colOffset);
+    }
+    else if (rowOffset == 0)
+    {
+        numberSuccessors += jumpAndAdd(nodeId, g, row, col, 0, colOffset);
+        if (isBlocked(row - 1, col))
+            numberSuccessors += jumpAndAdd(nodeId, g, row, col, -1,
+                                           colOffset);
+        if (isBlocked(row + 1, col))
+            numberSuccessors += jumpAndAdd(nodeId, g, row, col, 1,
+                                           colOffset);
+    }
+    else
+    {
+        numberSuccessors += jumpAndAdd(nodeId, g, row, col, rowOffset, 0);
+        if (isBlocked(row, col - 1))
+            numberSuccessors += jumpAndAdd(nodeId, g, row, col, rowOffset,
+                                           -1);
+        if (isBlocked(row, col + 1))
+            numberSuccessors += jumpAndAdd(nodeId, g, row, col, rowOffset,
+                                           1);
+    }
+    return numberSuccessors;
+}
+
+bool JumpPointSearch::findPath(const Environment& env, int start,
+                               int target)
+{
+    const Tiling* tiling = dynamic_cast<const Tiling*>(&env);
+    const TilingWindow* window = dynamic_cast<const TilingWindow*>(&env);
+    if (window != 0)
+        tiling = &window->getTiling();
+    if (tiling == 0 || ! isSupported(*tiling))
+        throw Error("JumpPointSearch needs a Tiling environment"
+                    " of type OCTILE.");
+    assert(env.isValidNodeId(start));
+    assert(env.isValidNodeId(target));
+    clock_t startTime = clock();
+    m_statistics.clear();
+    m_nodesExpanded = 0;
+    m_nodesVisited = 0;
+    m_tiling = tiling;
+    m_tilingColumns = tiling->getWidth();
+    if (window != 0)
+    {
+        m_originId = window->getGlobalId(0);
+        m_columns = window->getWidth();
+        m_rows = window->getHeight();
+    }
+    else
+    {
+        m_originId = 0;
+        m_columns = tiling->getWidth();
+        m_rows = tiling->getHeight();
+    }
+    m_target = target;
+    m_targetRow = target / m_columns;
+    m_targetCol = target % m_columns;
+    clearTrace();
+    m_path.clear();
+    m_pathCost = -1;
+    m_isAborted = false;
+    findPathJps(start);
+    double timeDiff =
+        static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
+    m_cpuTimeStatistics.add(timeDiff);
+    m_nodesExpandedStatistics.add(m_nodesExpanded);
+    m_nodesVisitedStatistics.add(m_nodesVisited);
+    m_pathLengthStatistics.add(m_path.size());
+    return ! m_isAborted;
+}
+
+void JumpPointSearch::findPathJps(int start)
+{
+    int maxopen = 0;
+    m_openSize = 1;
+    m_nodeStates.init(m_rows * m_columns);
+    m_open.init();
+    m_nodeStates.setOpen(start, 0, NO_NODE);
+    m_open.insert(start, 0, getHeuristic(start));
+    while (! m_open.isEmpty())
+    {
+        if (SAMPLE_EXPANSIONS)
+        {
+            m_openLengthStatistics.add(m_openSize);
+            if (m_openSize > maxopen)
+                maxopen = m_openSize;
+        }
+        int nodeId;
+        int g;
+        int f;
+        m_open.pop(nodeId, g, f);
+        // Skip outdated entries
+        if (m_nodeStates.getState(nodeId) != NodeStateArray::OPEN
+            || m_nodeStates.getG(nodeId) != g)
+            continue;
+        m_nodeStates.setClosed(nodeId);
+        --m_openSize;
+        ++m_nodesVisited;
+        traceVisited(nodeId);
+        if (nodeId == m_target)
+        {
+            constructPath(start);
+            m_pathCost = g;
+            m_pathCostStatistics.add(m_pathCost);
+            break;
+        }
+        if (m_nodesLimit >= 0 && m_nodesVisited > m_nodesLimit)
+        {
+            m_isAborted = true;
+            break;
+        }
+        ++m_nodesExpanded;
+        int numberSuccessors = expand(nodeId, g);
+        if (SAMPLE_EXPANSIONS)
+            m_branchingFactor.add(numberSuccessors);
+    }
+    if (SAMPLE_EXPANSIONS)
+        m_openMaxStatistics.add(maxopen);
+}
+
+const StatisticsCollection& JumpPointSearch::getStatistics() const
+{
+    return m_statistics;
+}
+
+const vector<char>& JumpPointSearch::getVisitedNodes() const
+{
+    return getVisitedNodeLabels(m_rows * m_columns);
+}
+
+bool JumpPointSearch::isSupported(const Tiling& tiling)
+{
+    return (tiling.getType() == Tiling::OCTILE);
+}
+
+int JumpPointSearch::jump(int row, int col, int rowOffset,
+                          int colOffset) const
+{
+    while (true)
+    {
+        if (! canMove(row, col, rowOffset, colOffset))
+            return NO_NODE;
+        row += rowOffset;
+        col += colOffset;
+        if (row == m_targetRow && col == m_targetCol)
+            return m_target;
+        if (rowOffset != 0 && colOffset != 0)
+        {
+            if ((isBlocked(row, col - colOffset)
+                 && ! isBlocked(row + rowOffset, col - colOffset))
+                || (isBlocked(row - rowOffset, col)
+                    && ! isBlocked(row - rowOffset, col + colOffset)))
+                return row * m_columns + col;
+            if (jump(row, col, rowOffset, 0) != NO_NODE
+                || jump(row, col, 0, colOffset) != NO_NODE)
+                return row * m_columns + col;
+        }
+        else if (rowOffset == 0)
+        {
+            if ((isBlocked(row - 1, col)
+                 && ! isBlocked(row - 1, col + colOffset))
+                || (isBlocked(row + 1, col)
+                    && ! isBlocked(row + 1, col + colOffset)))
+                return row * m_columns + col;
+        }
+        else
+        {
+            if ((isBlocked(row, col - 1)
+                 && ! isBlocked(row + rowOffset, col - 1))
+                || (isBlocked(row, col + 1)
+                    && ! isBlocked(row + rowOffset, col + 1)))
+                return row * m_columns + col;
+        }
+    }
+}
+
+int JumpPointSearch::jumpAndAdd(int nodeId, int g, int row, int col,
+                                int rowOffset, int colOffset)
+{
+    int jumpPoint = jump(row, col, rowOffset, colOffset);
+    if (jumpPoint == NO_NODE)
+        return 0;
+    // Jump points are counted as successors even if they are not added
+    int diffRow = abs(jumpPoint / m_columns - row);
+    int diffCol = abs(jumpPoint % m_columns - col);
+    int newg =
+        g + TilingHeuristic<Tiling::OCTILE>::getDistance(diffRow, diffCol);
+    NodeStateArray::State state = m_nodeStates.getState(jumpPoint);
+    if (state != NodeStateArray::UNSEEN
+        && newg >= m_nodeStates.getG(jumpPoint))
+        return 1;
+    m_nodeStates.setOpen(jumpPoint, newg, nodeId);
+    if (state != NodeStateArray::OPEN)
+        ++m_openSize;
+    m_open.insert(jumpPoint, newg, newg + getHeuristic(jumpPoint));
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,172 @@
+//-----------------------------------------------------------------------------
+/** @file jumppointsearch.h
+    Jump point search on octile tilings.
+
+    Short description of jump point search:
+
+    A* on a grid expands many nodes that only lie on one of several
+    symmetric paths of equal cost. Jump point search only generates
+    successors in the directions that cannot be reached at the same cost
+    without the expanded node (natural and forced neighbors), and
+    instead of adding the adjacent node it moves in that direction
+    until it reaches a node with forced neighbors, the target, or an
+    obstacle (jump). Diagonal jumps also stop at nodes from which a
+    straight jump finds such a node. Only the nodes where jumps stop
+    are added to the open list.
+
+    See D. Harabor, A. Grastien: Online Graph Pruning for Pathfinding on
+    Grid Maps (AAAI 2011).
+*/
+//-----------------------------------------------------------------------------
+
+#ifndef PATHFIND_JUMPPOINTSEARCH_H
+#define PATHFIND_JUMPPOINTSEARCH_H
+
+#include "basicastar.h"
+#include "nodestatearray.h"
+#include "search.h"
+
+//-----------------------------------------------------------------------------
+
+namespace PathFind
+{
+    using namespace std;
+
+    class Tiling;
+
+    /** Jump point search engine for tilings of type Tiling::OCTILE.
+        Searches a Tiling or a TilingWindow of such a tiling.
+        Reads the obstacles directly from the tiling instead of using
+        the edges of the environment. Diagonal moves follow the rule of
+        Tiling::canJump, they are only blocked if both adjacent nodes are
+        obstacles. Finds paths of the same cost as AStar, the path
+        contains all nodes, not only the jump points.
+        Collects the same statistics as AStar, nodes_expanded and
+        nodes_visited count jump points.
+    */
+    class JumpPointSearch
+        : public Search
+    {
+    public:
+        JumpPointSearch();
+
+        StatisticsCollection createStatistics();
+
+        /** Find a path.
+            @return false, if search was aborted due to node limit.
+            @throws Error, if the environment is not a Tiling or a
+            TilingWindow of a tiling of type OCTILE.
+        */
+        bool findPath(const Environment& env, int start, int target);
+
+        const vector<int>& getPath() const
+        {
+            return m_path;
+        }
+
+        int getPathCost() const
+        {
+            return m_pathCost;
+        }
+
+        const StatisticsCollection& getStatistics() const;
+
+        /** Get a vector with '+' char labels for each visited jump point.
+            @see Search::getVisitedNodes
+        */
+        const vector<char>& getVisitedNodes() const;
+
+        /** Check if a tiling can be searched with jump point search. */
+        static bool isSupported(const Tiling& tiling);
+
+    private:
+        bool m_isAborted;
+
+        int m_columns;
+
+        int m_rows;
+
+        int m_target;
+
+        int m_targetRow;
+
+        int m_targetCol;
+
+        int m_pathCost;
+
+        const Tiling* m_tiling;
+
+        /** Id in m_tiling of node 0 of the searched environment. */
+        int m_originId;
+
+        /** Width of m_tiling. */
+        int m_tilingColumns;
+
+        long long int m_nodesExpanded;
+
+        long long int m_nodesVisited;
+
+        /** Number of nodes in state OPEN. */
+        int m_openSize;
+
+        NodeStateArray m_nodeStates;
+
+        BasicOpenHeap m_open;
+
+        vector<int> m_path;
+
+        StatisticsCollection m_statistics;
+
+        Statistics& m_branchingFactor;
+
+        Statistics& m_cpuTimeStatistics;
+
+        Statistics& m_nodesExpandedStatistics;
+
+        Statistics& m_nodesVisitedStatistics;
+
+        Statistics& m_openLengthStatistics;
+
+        Statistics& m_openMaxStatistics;
+
+        Statistics& m_pathCostStatistics;
+
+        Statistics& m_pathLengthStatistics;
+
+        /** Check if a move to an adjacent node is possible. */
+        bool canMove(int row, int col, int rowOffset, int colOffset) const;
+
+        /** Construct the path with all nodes from the jump points. */
+        void constructPath(int start);
+
+        /** Generate the jump point successors of a node.
+            @return Number of successors.
+        */
+        int expand(int nodeId, int g);
+
+        void findPathJps(int start);
+
+        /** Get the octile distance from a node to the target. */
+        int getHeuristic(int nodeId) const;
+
+        /** Check if a node is outside the searched environment or an
+            obstacle.
+        */
+        bool isBlocked(int row, int col) const;
+
+        /** Move from a node into a direction until a jump point is found.
+            @return The jump point or NO_NODE.
+        */
+        int jump(int row, int col, int rowOffset, int colOffset) const;
+
+        /** Jump into a direction and add the jump point to open list.
+            @return 1 if a jump point was found, 0 otherwise.
+        */
+        int jumpAndAdd(int nodeId, int g, int row, int col, int rowOffset,
+                       int colOffset);
+    };
+}
+
+//-----------------------------------------------------------------------------
+
+#endif
@@ -2,6 +2,10 @@
 /** @file example.cpp
     Example program using the pathfinding library.
 
+    Usage: pf [options] mode number_runs cluster_size max_level ll_search
+    arguments...
+    The options are described at Options.
+
     $Id: example.cpp,v 1.24 2002/12/09 22:10:19 emarkus Exp $
     $Source: /usr/cvsroot/project_pathfind/example.cpp,v $
 */
@@ -18,11 +22,75 @@ using namespace PathFind;
 
 //-----------------------------------------------------------------------------
 
+/** Options given before the positional arguments.
+    <pre>
+    -bound b  suboptimality bound of the abstract main search (default 1)
+    -focal    use focal search instead of weighted A* if the bound is
+              larger than 1
+    -threads n  number of threads for the pre-processing of the
+              abstraction (default 1); with more threads the
+              pre-processing cpu_time includes all threads
+    </pre>
+*/
+class Options
+{
+public:
+    double m_suboptimalityBound;
+
+    AStar::SuboptimalMode m_suboptimalMode;
+
+    int m_numberThreads;
+
+    Options()
+        : m_suboptimalityBound(1),
+          m_suboptimalMode(AStar::SUBOPTIMAL_WEIGHTED),
+          m_numberThreads(1)
+    {
+    }
+
+    void apply(Experiment& experiment) const
+    {
+        experiment.setSuboptimalityBound(m_suboptimalityBound,
+                                         m_suboptimalMode);
+        experiment.setNumberThreads(m_numberThreads);
+    }
+};
+
+/** Parse the options.
+    @return Index of the first positional argument.
+*/
+static int parseOptions(int argc, char **argv, Options& options)
+{
+    int i = 1;
+    for ( ; i < argc && argv[i][0] == '-'; ++i)
+    {
+        string option = argv[i];
+        if (option == "-bound" && i + 1 < argc)
+            options.m_suboptimalityBound = atof(argv[++i]);
+        else if (option == "-focal")
+            options.m_suboptimalMode = AStar::SUBOPTIMAL_FOCAL;
+        else if (option == "-threads" && i + 1 < argc)
+            options.m_numberThreads = atoi(argv[++i]);
+        else
+        {
+            cerr << "Unknown option: " << option << '\n';
+            exit(-1);
+        }
+    }
+    return i;
+}
+
+//-----------------------------------------------------------------------------
+
 int main(int argc, char **argv)
 {
     for(int i = 0; i < argc; i++)
         cerr << argv[i] << " ";
     cerr << "\n";
+    Options options;
+    int firstArgument = parseOptions(argc, argv, options);
+    argc -= firstArgument - 1;
+    argv += firstArgument - 1;
     int readFromFile = atoi(argv[1]);
     int nrRuns = atoi(argv[2]);
     int clSize = atoi(argv[3]);
@@ -40,6 +108,7 @@ int main(int argc, char **argv)
                                   obstacle, (bool)llSearch, true, true,
                                   clSize, maxLevel, AbsWizard::END_ENTRANCE,
                                   A_STAR, Tiling::OCTILE);
+            options.apply(experiment);
             experiment.setupExperiment();
             experiment.runExperiment();
         }
@@ -60,6 +129,7 @@ int main(int argc, char **argv)
                                   0, (bool)llSearch, true, true,
                                   clSize, maxLevel, AbsWizard::END_ENTRANCE,
                                   A_STAR, Tiling::OCTILE);
+            options.apply(experiment);
             experiment.setupExperiment();
             experiment.runExperiment(start, target, argv[8]);
         }
@@ -78,6 +148,7 @@ int main(int argc, char **argv)
                                   0, (bool)llSearch, true, true,
                                   clSize, maxLevel, AbsWizard::END_ENTRANCE,
                                   A_STAR, Tiling::OCTILE);
+            options.apply(experiment);
             experiment.setupExperiment();
             experiment.runExperiment(argv[6]);
         }
@@ -96,6 +167,7 @@ int main(int argc, char **argv)
                                   0, (bool)llSearch, true, true,
                                   clSize, maxLevel, AbsWizard::END_ENTRANCE,
                                   A_STAR, Tiling::OCTILE);
+            options.apply(experiment);
             experiment.setupExperiment();
             experiment.runStorageExperiment(argv[6]);
         }
@@ -0,0 +1,41 @@
+//-----------------------------------------------------------------------------
+/** @file markerarray.cpp
+    @see markerarray.h
+*/
+//-----------------------------------------------------------------------------
+
+#include "markerarray.h"
+
+using namespace std;
+using namespace PathFind;
+
+//-----------------------------------------------------------------------------
+
+MarkerArray::MarkerArray()
+    : m_generation(1)
+{
+}
+
+void MarkerArray::clear()
+{
+    ++m_generation;
+    if (m_generation == 0)
+    {
+        m_generations.assign(m_generations.size(), 0);
+        m_generation = 1;
+    }
+}
+
+void MarkerArray::init(int size)
+{
+    assert(size >= 0);
+    if (size == getSize())
+    {
+        clear();
+        return;
+    }
+    m_generations.assign(size, 0);
+    m_generation = 1;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,73 @@
+//-----------------------------------------------------------------------------
+/** @file markerarray.h
+    Array of node markers that can be cleared in constant time.
+*/
+//-----------------------------------------------------------------------------
+
+#ifndef PATHFIND_MARKERARRAY_H
+#define PATHFIND_MARKERARRAY_H
+
+#include <assert.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+
+namespace PathFind
+{
+    using namespace std;
+
+    /** Array of markers indexed by node id.
+        Each entry stores the generation in which it was marked.
+        Clearing all markers only increments the current generation,
+        so the array is written completely only if its size changes or
+        the generation counter wraps around.
+        Used for reusing per-node state of search engines between searches
+        without O(number nodes) resets.
+    */
+    class MarkerArray
+    {
+    public:
+        MarkerArray();
+
+        /** Unmark all entries. */
+        void clear();
+
+        int getSize() const
+        {
+            return m_generations.size();
+        }
+
+        /** Initialize for a new search.
+            Resizes the array if necessary and unmarks all entries.
+        */
+        void init(int size);
+
+        bool isMarked(int index) const
+        {
+            assert(index >= 0 && index < getSize());
+            return (m_generations[index] == m_generation);
+        }
+
+        void mark(int index)
+        {
+            assert(index >= 0 && index < getSize());
+            m_generations[index] = m_generation;
+        }
+
+        void unmark(int index)
+        {
+            assert(index >= 0 && index < getSize());
+            m_generations[index] = 0;
+        }
+
+    private:
+        /** Current generation, never 0. */
+        unsigned int m_generation;
+
+        vector<unsigned int> m_generations;
+    };
+}
+
+//-----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,58 @@
+//-----------------------------------------------------------------------------
+/** @file nodestatearray.cpp
+    @see nodestatearray.h
+*/
+//-----------------------------------------------------------------------------
+
+#include "nodestatearray.h"
+
+#include <limits.h>
+
+using namespace std;
+using namespace PathFind;
+
+//-----------------------------------------------------------------------------
+
+NodeStateArray::NodeStateArray()
+    : m_numberNodes(0),
+      m_base(1)
+{
+}
+
+vector<int> NodeStateArray::constructPath(int start, int target) const
+{
+    vector<int> result;
+    int nodeId = target;
+    while (true)
+    {
+        result.push_back(nodeId);
+        if (nodeId == start)
+            break;
+        assert(getState(nodeId) != UNSEEN);
+        nodeId = m_parent[nodeId];
+    }
+    assert(*(result.end() - 1) == start);
+    return result;
+}
+
+void NodeStateArray::init(int numberNodes)
+{
+    assert(numberNodes >= 0);
+    if (numberNodes == m_numberNodes)
+    {
+        m_base += (CLOSED - OPEN + 1);
+        if (m_base > UINT_MAX - (CLOSED - OPEN))
+        {
+            m_state.assign(numberNodes, 0);
+            m_base = 1;
+        }
+        return;
+    }
+    m_state.assign(numberNodes, 0);
+    m_g.resize(numberNodes);
+    m_parent.resize(numberNodes);
+    m_numberNodes = numberNodes;
+    m_base = 1;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+//-----------------------------------------------------------------------------
+/** @file nodestatearray.h
+    Search state of nodes as parallel arrays indexed by node id.
+*/
+//-----------------------------------------------------------------------------
+
+#ifndef PATHFIND_NODESTATEARRAY_H
+#define PATHFIND_NODESTATEARRAY_H
+
+#include <assert.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+
+namespace PathFind
+{
+    using namespace std;
+
+    /** Search state of all nodes as parallel arrays indexed by node id.
+        Stores g, parent and whether a node is unseen, open or closed.
+        Entries are cleared in constant time by moving the range of
+        state values that belong to the current search, like the
+        generations in MarkerArray.
+    */
+    class NodeStateArray
+    {
+    public:
+        typedef enum {
+            UNSEEN,
+            OPEN,
+            CLOSED
+        } State;
+
+        NodeStateArray();
+
+        vector<int> constructPath(int start, int target) const;
+
+        int getG(int nodeId) const
+        {
+            assert(getState(nodeId) != UNSEEN);
+            return m_g[nodeId];
+        }
+
+        int getParent(int nodeId) const
+        {
+            assert(getState(nodeId) != UNSEEN);
+            return m_parent[nodeId];
+        }
+
+        State getState(int nodeId) const
+        {
+            assert(nodeId >= 0 && nodeId < m_numberNodes);
+            unsigned int state = m_state[nodeId];
+            if (state < m_base)
+                return UNSEEN;
+            return static_cast<State>(OPEN + (state - m_base));
+        }
+
+        /** Initialize for search.
+            Resizes the arrays if necessary and sets all nodes to UNSEEN.
+        */
+        void init(int numberNodes);
+
+        void setClosed(int nodeId)
+        {
+            assert(getState(nodeId) == OPEN);
+            m_state[nodeId] = m_base + (CLOSED - OPEN);
+        }
+
+        void setOpen(int nodeId, int g, int parent)
+        {
+            assert(nodeId >= 0 && nodeId < m_numberNodes);
+            m_state[nodeId] = m_base;
+            m_g[nodeId] = g;
+            m_parent[nodeId] = parent;
+        }
+
+    private:
+        int m_numberNodes;
+
+        /** State value for OPEN in the current search, never 0.
+            Smaller values are UNSEEN.
+        */
+        unsigned int m_base;
+
+        vector<unsigned int> m_state;
+
+        vector<int> m_g;
+
+        vector<int> m_parent;
+    };
+}
+
+//-----------------------------------------------------------------------------
+
+#endif
@@ -6,12 +6,22 @@
 #ifndef PATHFIND_H
 #define PATHFIND_H
 
+#include "arastar.h"
 #include "astar.h"
+#include "basicastar.h"
+#include "bidirastar.h"
+#include "dijkstra.h"
 #include "error.h"
+#include "fringesearch.h"
 #include "graph.h"
 #include "idastar.h"
+#include "jumppointsearch.h"
+#include "markerarray.h"
+#include "nodestatearray.h"
 #include "search.h"
+#include "searchpool.h"
 #include "searchutils.h"
+#include "threadpool.h"
 #include "tiling.h"
 
 #endif
@@ -10,6 +10,7 @@ using namespace PathFind;
 //-----------------------------------------------------------------------------
 
 Search::Search()
+    : m_traceMode(TRACE_OFF)
 {
     m_nodesLimit = -1;
 }
@@ -19,4 +20,27 @@ Search::~Search()
     ;
 }
 
+StatisticsCollection Search::createBasicStatistics()
+{
+    StatisticsCollection collection;
+    collection.create("cpu_time");
+    collection.create("path_cost");
+    collection.create("path_length");
+    collection.create("branching_factor");
+    collection.create("nodes_expanded");
+    collection.create("nodes_visited");
+    collection.create("open_length");
+    collection.create("open_max");
+    return collection;
+}
+
+const vector<char>& Search::getVisitedNodeLabels(int numberNodes) const
+{
+    m_visitedNodeLabels.assign(numberNodes, ' ');
+    for (vector<int>::const_iterator i = m_visitedNodeIds.begin();
+         i != m_visitedNodeIds.end(); ++i)
+        m_visitedNodeLabels[*i] = '+';
+    return m_visitedNodeLabels;
+}
+
 //-----------------------------------------------------------------------------
@@ -27,6 +27,15 @@ namespace PathFind
     class Search
     {
     public:
+        /** Recording of visited nodes during a search. */
+        typedef enum {
+            /** Do not record visited nodes. */
+            TRACE_OFF,
+
+            /** Record ids of visited nodes. */
+            TRACE_VISITED
+        } TraceMode;
+
         Search();
 
         virtual ~Search();
@@ -52,10 +61,28 @@ namespace PathFind
 
         virtual const vector<int>& getPath() const = 0;
 
+        TraceMode getTraceMode() const
+        {
+            return m_traceMode;
+        }
+
+        /** Get ids of nodes visited in last search.
+            Nodes are in order of first visit, AStar lists a node again
+            if it was reopened. Empty unless the trace mode was
+            TRACE_VISITED.
+        */
+        const vector<int>& getVisitedNodeIds() const
+        {
+            return m_visitedNodeIds;
+        }
+
         /** Get a vector with char labels for each visited node.
             Space char means not visited, otherwise the char
             can have different values and meanings depending on
             the concrete search engine.
+            Built from the trace on each call, so all labels are space
+            unless the trace mode was TRACE_VISITED.
+            Only intended for printing.
         */
         virtual const vector<char>& getVisitedNodes() const = 0;
 
@@ -63,6 +90,8 @@ namespace PathFind
         virtual const StatisticsCollection& getStatistics() const = 0;
 
         /** Set nodes limit for search engine.
+            A search is aborted when the number of visited nodes exceeds
+            the limit after visiting a node that is not the target.
             The default is -1 and means unlimited search.
         */
         void setNodesLimit(long long int nodesLimit)
@@ -70,6 +99,55 @@ namespace PathFind
             m_nodesLimit = nodesLimit;
         }
 
+        /** Set recording of visited nodes.
+            The default is TRACE_OFF.
+        */
+        void setTraceMode(TraceMode traceMode)
+        {
+            m_traceMode = traceMode;
+        }
+
+    protected:
+        /** Create the statistics tracked by every best-first engine.
+            Contains cpu_time, path_cost, path_length, branching_factor,
+            nodes_expanded, nodes_visited, open_length and open_max.
+            Engines add their own values to the returned collection.
+        */
+        static StatisticsCollection createBasicStatistics();
+
+        /** Label the nodes of the trace with '+'.
+            Implementation of getVisitedNodes() for engines that do not
+            distinguish between kinds of visited nodes.
+            @param numberNodes Number of nodes of the environment of the
+            last search.
+        */
+        const vector<char>& getVisitedNodeLabels(int numberNodes) const;
+
+        /** Clear the recorded nodes.
+            Must be called by findPath() before searching.
+        */
+        void clearTrace()
+        {
+            m_visitedNodeIds.clear();
+        }
+
+        bool isTracing() const
+        {
+            return (m_traceMode != TRACE_OFF);
+        }
+
+        void traceVisited(int nodeId)
+        {
+            if (m_traceMode == TRACE_VISITED)
+                m_visitedNodeIds.push_back(nodeId);
+        }
+
+    private:
+        TraceMode m_traceMode;
+
+        vector<int> m_visitedNodeIds;
+
+        mutable vector<char> m_visitedNodeLabels;
 
     public:
         long long int m_nodesLimit;
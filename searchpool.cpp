@@ -0,0 +1,118 @@
+//-----------------------------------------------------------------------------
+/** @file searchpool.cpp
+    @see searchpool.h
+*/
+//-----------------------------------------------------------------------------
+
+#include "searchpool.h"
+
+#include <assert.h>
+
+using namespace std;
+using namespace PathFind;
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+    /** Find an engine that is not in use.
+        @return Index of the engine or -1 if all are in use.
+    */
+    int findUnused(vector<bool>& inUse)
+    {
+        int numberEngines = inUse.size();
+        for (int i = 0; i < numberEngines; ++i)
+            if (! inUse[i])
+            {
+                inUse[i] = true;
+                return i;
+            }
+        return -1;
+    }
+
+    template<class SEARCH>
+    void releaseEngine(const vector<SEARCH*>& engines, vector<bool>& inUse,
+                       SEARCH& search)
+    {
+        int numberEngines = engines.size();
+        for (int i = 0; i < numberEngines; ++i)
+            if (engines[i] == &search)
+            {
+                assert(inUse[i]);
+                inUse[i] = false;
+                search.setNodesLimit(-1);
+                search.setTraceMode(Search::TRACE_OFF);
+                return;
+            }
+        assert(false);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+SearchPool::SearchPool()
+    : m_useJumpPointSearch(false)
+{
+}
+
+SearchPool::~SearchPool()
+{
+    for (vector<AStar*>::iterator i = m_engines.begin();
+         i != m_engines.end(); ++i)
+        delete *i;
+    for (vector<JumpPointSearch*>::iterator i = m_jumpPointEngines.begin();
+         i != m_jumpPointEngines.end(); ++i)
+        delete *i;
+    for (vector<Dijkstra*>::iterator i = m_dijkstraEngines.begin();
+         i != m_dijkstraEngines.end(); ++i)
+        delete *i;
+}
+
+AStar& SearchPool::acquire()
+{
+    int index = findUnused(m_inUse);
+    if (index >= 0)
+        return *m_engines[index];
+    m_engines.push_back(new AStar(AStar::CLOSED_AUTO,
+                                   AStar::OPEN_BINARY_HEAP));
+    m_inUse.push_back(true);
+    return *m_engines.back();
+}
+
+Dijkstra& SearchPool::acquireDijkstra()
+{
+    int index = findUnused(m_dijkstraInUse);
+    if (index >= 0)
+        return *m_dijkstraEngines[index];
+    m_dijkstraEngines.push_back(new Dijkstra());
+    m_dijkstraInUse.push_back(true);
+    return *m_dijkstraEngines.back();
+}
+
+JumpPointSearch& SearchPool::acquireJumpPointSearch()
+{
+    int index = findUnused(m_jumpPointInUse);
+    if (index >= 0)
+        return *m_jumpPointEngines[index];
+    m_jumpPointEngines.push_back(new JumpPointSearch());
+    m_jumpPointInUse.push_back(true);
+    return *m_jumpPointEngines.back();
+}
+
+void SearchPool::release(AStar& search)
+{
+    releaseEngine(m_engines, m_inUse, search);
+    search.setSuboptimalityBound(1);
+}
+
+void SearchPool::release(Dijkstra& search)
+{
+    releaseEngine(m_dijkstraEngines, m_dijkstraInUse, search);
+}
+
+void SearchPool::release(JumpPointSearch& search)
+{
+    releaseEngine(m_jumpPointEngines, m_jumpPointInUse, search);
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,171 @@
+//-----------------------------------------------------------------------------
+/** @file searchpool.h
+    Pool of reusable search engines.
+*/
+//-----------------------------------------------------------------------------
+
+#ifndef PATHFIND_SEARCHPOOL_H
+#define PATHFIND_SEARCHPOOL_H
+
+#include <vector>
+#include "astar.h"
+#include "dijkstra.h"
+#include "jumppointsearch.h"
+
+//-----------------------------------------------------------------------------
+
+namespace PathFind
+{
+    using namespace std;
+
+    /** Pool of A*, jump point search and Dijkstra engines that are reused
+        between searches.
+        Engines keep their closed and open lists between searches, so
+        running many searches on the same environment does not allocate
+        after the first one.
+        Engines are created on demand, if all existing engines are in use.
+        A pool is not thread-safe, each thread running searches must use
+        its own pool.
+    */
+    class SearchPool
+    {
+    public:
+        /** Engine lent from a pool.
+            The engine is returned to the pool when the lease is destroyed.
+            SEARCH is AStar, JumpPointSearch or Dijkstra.
+        */
+        template<class SEARCH>
+        class BasicLease
+        {
+        public:
+            explicit BasicLease(SearchPool& pool)
+                : m_pool(pool),
+                  m_search(pool.acquire(static_cast<SEARCH*>(0)))
+            {
+            }
+
+            ~BasicLease()
+            {
+                m_pool.release(m_search);
+            }
+
+            SEARCH& operator*() const
+            {
+                return m_search;
+            }
+
+            SEARCH* operator->() const
+            {
+                return &m_search;
+            }
+
+        private:
+            SearchPool& m_pool;
+
+            SEARCH& m_search;
+
+            /** Not implemented. */
+            BasicLease(const BasicLease&);
+
+            /** Not implemented. */
+            BasicLease& operator=(const BasicLease&);
+        };
+
+        template<class SEARCH> friend class BasicLease;
+
+        typedef BasicLease<AStar> Lease;
+
+        typedef BasicLease<JumpPointSearch> JumpPointLease;
+
+        typedef BasicLease<Dijkstra> DijkstraLease;
+
+        SearchPool();
+
+        ~SearchPool();
+
+        /** Get an A* engine that is not in use.
+            Prefer using a Lease.
+        */
+        AStar& acquire();
+
+        /** Get a Dijkstra engine that is not in use.
+            Prefer using a DijkstraLease.
+        */
+        Dijkstra& acquireDijkstra();
+
+        /** Get a jump point search engine that is not in use.
+            Prefer using a JumpPointLease.
+        */
+        JumpPointSearch& acquireJumpPointSearch();
+
+        int getNumberEngines() const
+        {
+            return (m_engines.size() + m_jumpPointEngines.size()
+                    + m_dijkstraEngines.size());
+        }
+
+        /** Check if users of the pool should prefer jump point search.
+            @see setUseJumpPointSearch
+        */
+        bool getUseJumpPointSearch() const
+        {
+            return m_useJumpPointSearch;
+        }
+
+        void release(AStar& search);
+
+        void release(Dijkstra& search);
+
+        void release(JumpPointSearch& search);
+
+        /** Prefer jump point search for searches on tilings that it
+            supports.
+            Only a hint to the users of the pool, acquiring engines is
+            not affected. The default is false.
+        */
+        void setUseJumpPointSearch(bool enable)
+        {
+            m_useJumpPointSearch = enable;
+        }
+
+    private:
+        bool m_useJumpPointSearch;
+
+        vector<AStar*> m_engines;
+
+        vector<bool> m_inUse;
+
+        vector<JumpPointSearch*> m_jumpPointEngines;
+
+        vector<bool> m_jumpPointInUse;
+
+        vector<Dijkstra*> m_dijkstraEngines;
+
+        vector<bool> m_dijkstraInUse;
+
+        AStar& acquire(AStar*)
+        {
+            return acquire();
+        }
+
+        JumpPointSearch& acquire(JumpPointSearch*)
+        {
+            return acquireJumpPointSearch();
+        }
+
+        Dijkstra& acquire(Dijkstra*)
+        {
+            return acquireDijkstra();
+        }
+
+        /** Not implemented. */
+        SearchPool(const SearchPool&);
+
+        /** Not implemented. */
+        SearchPool& operator=(const SearchPool&);
+    };
+}
+
+//-----------------------------------------------------------------------------
+
+#endif
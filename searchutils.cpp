@@ -50,23 +50,22 @@ bool SearchUtils::searchPathExists(int node, int depth)
         return true;
     m_mark[node] = true;
     assert(depth >= 0);
-    if (m_successorStack.size() < static_cast<unsigned int>(depth + 1))
-        m_successorStack.resize(depth + 1);
-    assert(static_cast<unsigned int>(depth) < m_successorStack.size());
-    vector<Environment::Successor>& successors = m_successorStack[depth];
-    m_env->getSuccessors(node, NO_NODE, successors);
-    int numberSuccessors = successors.size();
-    for (int i = 0; i < numberSuccessors; ++i)
+    SuccessorSearch successorSearch(*this, depth);
+    m_env->visitSuccessors(node, NO_NODE, successorSearch);
+    return successorSearch.isPathFound();
+}
+
+//-----------------------------------------------------------------------------
+
+bool SearchUtils::SuccessorSearch::visit(int target, int cost)
+{
+    assert(m_utils.m_env->isValidNodeId(target));
+    if (m_utils.searchPathExists(target, m_depth + 1))
     {
-        // Get reference on successor again, because resize could have
-        // changed it.
-        const Environment::Successor& successor = m_successorStack[depth][i];
-        int targetNodeId = successor.m_target;
-        assert(m_env->isValidNodeId(targetNodeId));
-        if (searchPathExists(targetNodeId, depth + 1))
-            return true;
+        m_isPathFound = true;
+        return false;
     }
-    return false;
+    return true;
 }
 
 //-----------------------------------------------------------------------------
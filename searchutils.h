@@ -33,7 +33,38 @@ namespace PathFind
 
         vector<bool> m_mark;
 
-        vector<vector<Environment::Successor> > m_successorStack;
+        class SuccessorSearch;
+
+        friend class SuccessorSearch;
+
+        /** Visitor that continues the depth-first search at each
+            successor of a node and stops once the target was reached.
+        */
+        class SuccessorSearch
+            : public Environment::SuccessorVisitor
+        {
+        public:
+            SuccessorSearch(SearchUtils& utils, int depth)
+                : m_utils(utils),
+                  m_depth(depth),
+                  m_isPathFound(false)
+            {
+            }
+
+            bool isPathFound() const
+            {
+                return m_isPathFound;
+            }
+
+            bool visit(int target, int cost);
+
+        private:
+            SearchUtils& m_utils;
+
+            int m_depth;
+
+            bool m_isPathFound;
+        };
 
         bool searchPathExists(int node, int depth);
     };
@@ -16,36 +16,46 @@ using namespace PathFind;
 
 //-----------------------------------------------------------------------------
 
-SmoothWizard::SmoothWizard(Tiling tiling, vector<int> path)
-    :m_tiling(tiling, 0, 0, tiling.getWidth(), tiling.getHeight()),
-     m_initPath(path),
-     m_statistics(createStatistics())
+SmoothWizard::SmoothWizard(const Tiling& tiling)
+    :m_tiling(tiling),
+     m_statistics(createStatistics()),
+     m_cpuTimeStatistics(m_statistics.get("cpu_time")),
+     m_improvementStatistics(m_statistics.get("improvement")),
+     m_nrImprovementsStatistics(m_statistics.get("nr_improvements")),
+     m_numberRunsStatistics(m_statistics.get("number_runs")),
+     m_pathCostStatistics(m_statistics.get("path_cost"))
 {
-    memset(m_pathMap, 0, sizeof(int)*1000000);//262144);
-    for (unsigned int i = 0; i < m_initPath.size(); i++)
-    {
-        m_pathMap[m_initPath[i]] = i + 1;
-    }
 }
 
-SmoothWizard::SmoothWizard()
-    :m_tiling(Tiling(Tiling::TILE, 0, 0))
+SmoothWizard::~SmoothWizard()
 {
 
 }
 
-SmoothWizard::~SmoothWizard()
+inline int SmoothWizard::getPathIndex(int nodeId) const
 {
-
+    if (! m_isOnPath.isMarked(nodeId))
+        return NO_INDEX;
+    return m_pathMap[nodeId];
 }
 
-
 //-----------------------------------------------------------------------------
 
-void SmoothWizard::smoothPath()
+void SmoothWizard::smoothPath(const vector<int>& path)
 {
     clock_t startTime = clock();
     m_statistics.clear();
+    m_initPath = path;
+    m_smoothPath.clear();
+    int numberNodes = m_tiling.getNumberNodes();
+    m_isOnPath.init(numberNodes);
+    if (static_cast<int>(m_pathMap.size()) != numberNodes)
+        m_pathMap.resize(numberNodes);
+    for (unsigned int i = 0; i < m_initPath.size(); i++)
+    {
+        m_isOnPath.mark(m_initPath[i]);
+        m_pathMap[m_initPath[i]] = i + 1;
+    }
     if (m_tiling.getPathCost(m_initPath) == m_tiling.getHeuristic(m_initPath[0],
                                                                   m_initPath[m_initPath.size() - 1]))
     {
@@ -53,7 +63,7 @@ void SmoothWizard::smoothPath()
     }
     else
     {
-        m_statistics.get("number_runs").add(1);
+        m_numberRunsStatistics.add(1);
         for (unsigned int j = 0; j < m_initPath.size(); j++)
         {
             // add this node to the smoothed path
@@ -73,11 +83,11 @@ void SmoothWizard::smoothPath()
                 if (j < m_initPath.size() - 1 && seenPathNode == m_initPath[j + 1])
                     continue;
                 int newLength = addPathPortion(m_initPath[j], seenPathNode, dir);
-                int oldLength = COST_ONE*(m_pathMap[seenPathNode] - (j+1));
-                j = m_pathMap[seenPathNode] - 2;
+                int oldLength = COST_ONE*(getPathIndex(seenPathNode) - (j+1));
+                j = getPathIndex(seenPathNode) - 2;
                 // count the path reduction (e.g., 2)
-                m_statistics.get("nr_improvements").add(1);
-                m_statistics.get("improvement").add((oldLength - newLength));
+                m_nrImprovementsStatistics.add(1);
+                m_improvementStatistics.add((oldLength - newLength));
                 break;
             }
         }
@@ -85,8 +95,8 @@ void SmoothWizard::smoothPath()
 
     double timeDiff =
         static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
-    m_statistics.get("cpu_time").add(timeDiff);
-    m_statistics.get("path_cost").add(m_tiling.getPathCost(m_smoothPath));
+    m_cpuTimeStatistics.add(timeDiff);
+    m_pathCostStatistics.add(m_tiling.getPathCost(m_smoothPath));
 }
 
 int SmoothWizard::getPathNodeId(const int originId, int direction)
@@ -101,12 +111,11 @@ int SmoothWizard::getPathNodeId(const int originId, int direction)
             return NO_NODE;
         if (!m_tiling.canJump(nodeId, lastNodeId))
             return NO_NODE;
-        if (m_pathMap[nodeId] != NO_INDEX && m_pathMap[nodeId] > m_pathMap[originId])
+        if (getPathIndex(nodeId) > getPathIndex(originId))
         {
             return nodeId;
         }
-        const TilingNodeInfo &newNodeInfo = m_tiling.getNodeInfo(nodeId);
-        if (newNodeInfo.isObstacle())
+        if (m_tiling.isObstacle(nodeId))
         {
             return NO_NODE;
         }
@@ -5,6 +5,7 @@
 #ifndef PATHFIND_SMOOTHWIZARD_H
 #define PATHFIND_SMOOTHWIZARD_H
 
+#include "markerarray.h"
 #include "pathfind.h"
 #include "util.h"
 
@@ -25,10 +26,21 @@ namespace PathFind
             SW,
             NW} Direction;
 
-        SmoothWizard(Tiling tiling, vector<int> path);
-        SmoothWizard();
+        /** Constructor.
+            The tiling is not copied and must outlive the wizard.
+        */
+        SmoothWizard(const Tiling& tiling);
+
         ~SmoothWizard();
-        void smoothPath();
+
+        /** Smooth a path of the tiling.
+            Can be called for several paths; the cost of a call depends
+            only on the length of the path and of the straight lines
+            checked for shortcuts, not on the size of the tiling.
+            Clears the statistics of the previous call.
+        */
+        void smoothPath(const vector<int>& path);
+
         const vector<int>& getInitPath() const
         {
             return m_initPath;
@@ -37,17 +49,31 @@ namespace PathFind
         {
             return m_smoothPath;
         }
-        StatisticsCollection createStatistics();
+        static StatisticsCollection createStatistics();
         const StatisticsCollection& getStatistics() const;
     private:
-        Tiling m_tiling;
+        const Tiling& m_tiling;
         vector<int> m_initPath;
         vector<int> m_smoothPath;
-        int m_pathMap[1000000];//262144];
+        /** Nodes of the initial path. */
+        MarkerArray m_isOnPath;
+        /** Index + 1 of each node in the initial path.
+            Only valid for nodes marked in m_isOnPath.
+        */
+        vector<int> m_pathMap;
         StatisticsCollection m_statistics;
+        Statistics& m_cpuTimeStatistics;
+        Statistics& m_improvementStatistics;
+        Statistics& m_nrImprovementsStatistics;
+        Statistics& m_numberRunsStatistics;
+        Statistics& m_pathCostStatistics;
 
     private:
         bool checkPathSequence();
+        /** Get the index + 1 of a node in the initial path.
+            @return NO_INDEX, if the node is not on the path.
+        */
+        int getPathIndex(int nodeId) const;
         int getPathNodeId(const int origin, int direction);
         int advanceNode(int nodeId, int direction);
         int addPathPortion(int originId, int finalId, int direction);
@@ -21,6 +21,17 @@ namespace PathFind
 {
     using namespace std;
 
+    /** Whether searches sample statistics once per node expansion.
+        Compile with PATHFIND_NO_EXPANSION_STATISTICS defined to remove
+        the sampling from the inner loops of the searches. Statistics
+        like branching_factor and open_length stay empty in this case.
+    */
+#ifdef PATHFIND_NO_EXPANSION_STATISTICS
+    static const bool SAMPLE_EXPANSIONS = false;
+#else
+    static const bool SAMPLE_EXPANSIONS = true;
+#endif
+
     /** Keeps track of the mean and variance of a variable. */
     class Statistics
     {
@@ -73,6 +84,11 @@ namespace PathFind
 
         void create(const string& name);
 
+        /** Get a statistics variable by name.
+            The reference stays valid for the lifetime of the collection,
+            searches should look up the variables they update in their
+            constructor instead of calling this function in the search.
+        */
         Statistics& get(const string& name);
 
         void print(ostream& o) const;
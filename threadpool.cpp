@@ -0,0 +1,202 @@
+//-----------------------------------------------------------------------------
+/** @file threadpool.cpp
+    @see threadpool.h
+*/
+//-----------------------------------------------------------------------------
+
+#include "threadpool.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <unistd.h>
+#include "error.h"
+
+using namespace std;
+using namespace PathFind;
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+    /** Lock of a mutex for the lifetime of the object. */
+    class Lock
+    {
+    public:
+        explicit Lock(pthread_mutex_t& mutex)
+            : m_mutex(mutex)
+        {
+            pthread_mutex_lock(&m_mutex);
+        }
+
+        ~Lock()
+        {
+            pthread_mutex_unlock(&m_mutex);
+        }
+
+    private:
+        pthread_mutex_t& m_mutex;
+    };
+
+    /** State of a run shared by all threads. */
+    class RunState
+    {
+    public:
+        RunState(ThreadPool::Task& task, int numberItems)
+            : m_task(task),
+              m_numberItems(numberItems),
+              m_nextItem(0),
+              m_isFailed(false)
+        {
+            pthread_mutex_init(&m_mutex, 0);
+        }
+
+        ~RunState()
+        {
+            pthread_mutex_destroy(&m_mutex);
+        }
+
+        /** Get the next item to process.
+            @return false, if all items were handed out or a task failed.
+        */
+        bool getNextItem(int& item)
+        {
+            Lock lock(m_mutex);
+            if (m_isFailed || m_nextItem >= m_numberItems)
+                return false;
+            item = m_nextItem++;
+            return true;
+        }
+
+        bool isFailed() const
+        {
+            return m_isFailed;
+        }
+
+        const string& getMessage() const
+        {
+            return m_message;
+        }
+
+        ThreadPool::Task& getTask()
+        {
+            return m_task;
+        }
+
+        void setFailed(const string& message)
+        {
+            Lock lock(m_mutex);
+            if (m_isFailed)
+                return;
+            m_isFailed = true;
+            m_message = message;
+        }
+
+    private:
+        ThreadPool::Task& m_task;
+
+        int m_numberItems;
+
+        int m_nextItem;
+
+        bool m_isFailed;
+
+        string m_message;
+
+        pthread_mutex_t m_mutex;
+    };
+
+    /** Argument of a thread. */
+    class Worker
+    {
+    public:
+        RunState* m_state;
+
+        int m_thread;
+
+        pthread_t m_id;
+
+        bool m_isStarted;
+    };
+
+    void work(RunState& state, int thread)
+    {
+        int item;
+        while (state.getNextItem(item))
+        {
+            try
+            {
+                state.getTask().run(item, thread);
+            }
+            catch (const exception& e)
+            {
+                state.setFailed(e.what());
+            }
+            catch (...)
+            {
+                state.setFailed("Unknown exception in thread.");
+            }
+        }
+    }
+
+    extern "C" void* startWorker(void* argument)
+    {
+        Worker* worker = static_cast<Worker*>(argument);
+        work(*worker->m_state, worker->m_thread);
+        return 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+ThreadPool::Task::~Task()
+{
+}
+
+//-----------------------------------------------------------------------------
+
+ThreadPool::ThreadPool(int numberThreads)
+    : m_numberThreads(numberThreads)
+{
+    if (numberThreads < 1)
+        throw Error("ThreadPool: number of threads must be at least 1.");
+}
+
+int ThreadPool::getNumberProcessors()
+{
+    long numberProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+    if (numberProcessors < 1)
+        return 1;
+    return static_cast<int>(numberProcessors);
+}
+
+void ThreadPool::run(Task& task, int numberItems)
+{
+    if (m_numberThreads == 1 || numberItems <= 1)
+    {
+        for (int i = 0; i < numberItems; ++i)
+            task.run(i, 0);
+        return;
+    }
+    RunState state(task, numberItems);
+    int numberWorkers = min(m_numberThreads, numberItems) - 1;
+    vector<Worker> workers(numberWorkers);
+    for (int i = 0; i < numberWorkers; ++i)
+    {
+        Worker& worker = workers[i];
+        worker.m_state = &state;
+        worker.m_thread = i + 1;
+        worker.m_isStarted =
+            (pthread_create(&worker.m_id, 0, startWorker, &worker) == 0);
+    }
+    work(state, 0);
+    for (int i = 0; i < numberWorkers; ++i)
+        if (workers[i].m_isStarted)
+            pthread_join(workers[i].m_id, 0);
+    if (state.isFailed())
+        throw Error(state.getMessage());
+}
+
+//-----------------------------------------------------------------------------
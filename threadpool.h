@@ -0,0 +1,74 @@
+//-----------------------------------------------------------------------------
+/** @file threadpool.h
+    Running independent work items on several threads.
+*/
+//-----------------------------------------------------------------------------
+
+#ifndef PATHFIND_THREADPOOL_H
+#define PATHFIND_THREADPOOL_H
+
+//-----------------------------------------------------------------------------
+
+namespace PathFind
+{
+    /** Fixed number of threads that process the items of a task.
+        The calling thread works as the first thread, the other threads
+        are started by each run() and joined before it returns. Items are
+        handed out one at a time in increasing order, so items of uneven
+        cost are balanced between the threads.
+        Uses POSIX threads.
+    */
+    class ThreadPool
+    {
+    public:
+        /** Work done for the items of a run. */
+        class Task
+        {
+        public:
+            virtual ~Task();
+
+            /** Process an item.
+                Called concurrently for different items. Implementations
+                must only share state that is not modified during the run,
+                and keep other state per thread or per item.
+                @param item Index of the item.
+                @param thread Index of the thread, between 0 and
+                ThreadPool::getNumberThreads() - 1.
+            */
+            virtual void run(int item, int thread) = 0;
+        };
+
+        /** Constructor.
+            @param numberThreads Number of threads including the calling
+            thread.
+            @throws Error, if numberThreads is smaller than 1.
+        */
+        explicit ThreadPool(int numberThreads = 1);
+
+        int getNumberThreads() const
+        {
+            return m_numberThreads;
+        }
+
+        /** Number of processors online, 1 if unknown. */
+        static int getNumberProcessors();
+
+        /** Process the items from 0 to numberItems - 1.
+            With one thread, the items are processed in order and
+            exceptions of the task are passed on unchanged. Threads that
+            cannot be started are skipped, their items are processed by
+            the other threads.
+            @throws Error, if the task threw an exception with more than
+            one thread, with the message of the first exception. Items
+            that were not started yet are not processed in this case.
+        */
+        void run(Task& task, int numberItems);
+
+    private:
+        int m_numberThreads;
+    };
+}
+
+//-----------------------------------------------------------------------------
+
+#endif
@@ -17,6 +17,38 @@ using namespace PathFind;
 
 //-----------------------------------------------------------------------------
 
+namespace
+{
+    /** Row offsets of the move directions, see Tiling::m_moves. */
+    const int DIRECTION_ROW[] = { -1, 1, 0, 0, 1, 1, -1, -1 };
+
+    /** Column offsets of the move directions, see Tiling::m_moves. */
+    const int DIRECTION_COL[] = { 0, 0, -1, 1, 1, -1, 1, -1 };
+
+    /** Direction to an adjacent position.
+        Indexed by row offset + 1 and column offset + 1.
+    */
+    const int DIRECTION_INDEX[3][3] = {
+        { 7, 0, 6 },
+        { 2, -1, 3 },
+        { 5, 1, 4 }
+    };
+
+    /** Moves with a northward component (N, NE, NW). */
+    const unsigned int MOVES_NORTH = 0xc1;
+
+    /** Moves with a southward component (S, SE, SW). */
+    const unsigned int MOVES_SOUTH = 0x32;
+
+    /** Moves with a westward component (W, SW, NW). */
+    const unsigned int MOVES_WEST = 0xa4;
+
+    /** Moves with an eastward component (E, SE, NE). */
+    const unsigned int MOVES_EAST = 0x58;
+}
+
+//-----------------------------------------------------------------------------
+
 TilingNodeInfo::TilingNodeInfo()
     : m_isObstacle(false),
       m_column(-1),
@@ -50,21 +82,12 @@ Tiling::Tiling(const Tiling & tiling, int horizOrigin, int vertOrigin, int width
     {
         // get the local node
         int localNodeId = getNodeId(row, col);
-        TilingNodeInfo& localNodeInfo = m_graph.getNodeInfo(localNodeId);
         // get the initial tiling node
         int nodeId = tiling.getNodeId(vertOrigin + row, horizOrigin + col);
-        const TilingNodeInfo& nodeInfo = tiling.getNodeInfo(nodeId);
         // set obstacle for the local node
-        if (nodeInfo.isObstacle())
-        {
-            localNodeInfo.setObstacle(true);
-        }
-        else
-        {
-            localNodeInfo.setObstacle(false);
-//            m_storageStatistics.get("nodes").add(1);
-        }
+        m_obstacles[localNodeId] = tiling.isObstacle(nodeId);
     }
+    updateMoves();
 }
 
 Tiling::Tiling(LineReader& reader)
@@ -132,6 +155,7 @@ Tiling::Tiling(LineReader& reader)
         throw reader.createError("Map without type.");
     init(type, rows, columns);
     readObstacles(reader);
+    updateMoves();
     countRealEdges();
 }
 
@@ -153,21 +177,63 @@ void Tiling::clearStatistics()
     m_storageStatistics.clear();
 }
 
-void Tiling::addOutEdge(int nodeId, int row, int col, int cost)
+void Tiling::clearObstacles()
 {
-    if (row < 0 || row >= m_rows || col < 0 || col >= m_columns)
-        return;
-    m_graph.addOutEdge(nodeId, getNodeId(row, col), TilingEdgeInfo(cost));
+    m_obstacles.assign(getNumberNodes(), false);
+    updateMoves();
 }
 
-void Tiling::clearObstacles()
+unsigned int Tiling::computeMoves(int row, int col) const
 {
-    int numberNodes = getNumberNodes();
-    for (int nodeId = 0; nodeId < numberNodes; ++nodeId)
+    int nodeId = getNodeId(row, col);
+    if (m_obstacles[nodeId])
+        return 0;
+    bool hasNorth = (row > 0);
+    bool hasSouth = (row < m_rows - 1);
+    bool hasWest = (col > 0);
+    bool hasEast = (col < m_columns - 1);
+    // Neighbors on the map that are not obstacles
+    unsigned int free = 0;
+    if (hasNorth && ! m_obstacles[nodeId - m_columns])
+        free |= 0x01;
+    if (hasSouth && ! m_obstacles[nodeId + m_columns])
+        free |= 0x02;
+    if (hasWest && ! m_obstacles[nodeId - 1])
+        free |= 0x04;
+    if (hasEast && ! m_obstacles[nodeId + 1])
+        free |= 0x08;
+    if (hasSouth && hasEast && ! m_obstacles[nodeId + m_columns + 1])
+        free |= 0x10;
+    if (hasSouth && hasWest && ! m_obstacles[nodeId + m_columns - 1])
+        free |= 0x20;
+    if (hasNorth && hasEast && ! m_obstacles[nodeId - m_columns + 1])
+        free |= 0x40;
+    if (hasNorth && hasWest && ! m_obstacles[nodeId - m_columns - 1])
+        free |= 0x80;
+    switch (m_type)
     {
-        TilingNodeInfo& nodeInfo = m_graph.getNodeInfo(nodeId);
-        nodeInfo.setObstacle(false);
+    case HEX:
+        return free & (col % 2 == 0 ? 0xcf : 0x3f);
+    case OCTILE:
+    case OCTILE_UNICOST:
+        {
+            unsigned int moves = free;
+            // Diagonal moves between two obstacles are not allowed, see
+            // canJump
+            if ((free & 0x0a) == 0)
+                moves &= ~0x10;
+            if ((free & 0x06) == 0)
+                moves &= ~0x20;
+            if ((free & 0x09) == 0)
+                moves &= ~0x40;
+            if ((free & 0x05) == 0)
+                moves &= ~0x80;
+            return moves;
+        }
+    case TILE:
+        break;
     }
+    return free & 0x0f;
 }
 
 void Tiling::countRealEdges()
@@ -273,60 +339,6 @@ void Tiling::countRealEdges()
         }
 }
 
-void Tiling::createEdges()
-{
-    assert(m_type == TILE
-           || m_type == OCTILE
-           || m_type == OCTILE_UNICOST
-           || m_type == HEX);
-    for (int row = 0; row < m_rows; ++row)
-        for (int col = 0; col < m_columns; ++col)
-        {
-            int nodeId = getNodeId(row, col);
-            addOutEdge(nodeId, row - 1, col, COST_ONE);
-            addOutEdge(nodeId, row + 1, col, COST_ONE);
-            addOutEdge(nodeId, row, col - 1, COST_ONE);
-            addOutEdge(nodeId, row, col + 1, COST_ONE);
-            if (m_type == OCTILE)
-            {
-                addOutEdge(nodeId, row + 1, col + 1, COST_SQRT2);
-                addOutEdge(nodeId, row + 1, col - 1, COST_SQRT2);
-                addOutEdge(nodeId, row - 1, col + 1, COST_SQRT2);
-                addOutEdge(nodeId, row - 1, col - 1, COST_SQRT2);
-            }
-            else if (m_type == OCTILE_UNICOST)
-            {
-                addOutEdge(nodeId, row + 1, col + 1, COST_ONE);
-                addOutEdge(nodeId, row + 1, col - 1, COST_ONE);
-                addOutEdge(nodeId, row - 1, col + 1, COST_ONE);
-                addOutEdge(nodeId, row - 1, col - 1, COST_ONE);
-            }
-            else if (m_type == HEX)
-            {
-                if (col % 2 == 0)
-                {
-                    addOutEdge(nodeId, row - 1, col + 1, COST_ONE);
-                    addOutEdge(nodeId, row - 1, col - 1, COST_ONE);
-                }
-                else
-                {
-                    addOutEdge(nodeId, row + 1, col + 1, COST_ONE);
-                    addOutEdge(nodeId, row + 1, col - 1, COST_ONE);
-                }
-            }
-        }
-}
-
-void Tiling::createNodes()
-{
-    for (int row = 0; row < m_rows; ++row)
-        for (int col = 0; col < m_columns; ++col)
-        {
-            int nodeId = getNodeId(row, col);
-            m_graph.addNode(nodeId, TilingNodeInfo(false, row, col));
-        }
-}
-
 vector<char> Tiling::getCharVector() const
 {
     vector<char> result;
@@ -334,7 +346,7 @@ vector<char> Tiling::getCharVector() const
     result.reserve(numberNodes);
     for (int i = 0; i < numberNodes; ++i)
     {
-        if (m_graph.getNodeInfo(i).isObstacle())
+        if (isObstacle(i))
             result.push_back('@');
         else
             result.push_back('.');
@@ -430,30 +442,8 @@ void Tiling::getSuccessors(int nodeId, int lastNodeId,
 {
     result.reserve(m_maxEdges);
     result.clear();
-    const TilingNode& node = m_graph.getNode(nodeId);
-    const TilingNodeInfo& nodeInfo = node.getInfo();
-    if (nodeInfo.isObstacle())
-    {
-        assert(result.size() == 0);
-        return;
-    }
-    const vector<TilingEdge>& edges = node.getOutEdges(); 
-    for (vector<TilingEdge>::const_iterator i = edges.begin();
-         i != edges.end(); ++i)
-    {
-        int targetNodeId = i->getTargetNodeId();
-        assert(isValidNodeId(targetNodeId));
-        const TilingNode& targetNode = m_graph.getNode(targetNodeId);
-        const TilingNodeInfo& targetNodeInfo = targetNode.getInfo();
-        if (!canJump(targetNodeId, nodeId))
-            continue;
-        if (targetNodeInfo.isObstacle())
-            continue;
-        if (lastNodeId != NO_NODE)
-            if (pruneNode(targetNodeId, lastNodeId))
-                continue;
-        result.push_back(Successor(targetNodeId, i->getInfo().getCost()));
-    }
+    SuccessorCollector collector(result);
+    visitSuccessors(nodeId, lastNodeId, collector);
 #ifndef NDEBUG
     int resultSize = result.size();
     assert(resultSize <= m_maxEdges);
@@ -472,15 +462,65 @@ void Tiling::getSuccessors(int nodeId, int lastNodeId,
 #endif
 }
 
+void Tiling::visitSuccessors(int nodeId, int lastNodeId,
+                             SuccessorVisitor& visitor) const
+{
+    unsigned int moves = m_moves[nodeId];
+    if (lastNodeId != NO_NODE && moves != 0)
+        moves &= ~getPrunedMoves(nodeId, lastNodeId, moves);
+    for (int i = 0; moves != 0; ++i, moves >>= 1)
+        if ((moves & 1) != 0
+            && ! visitor.visit(nodeId + m_directionOffset[i],
+                               m_directionCost[i]))
+            return;
+}
+
 void Tiling::init(Type type, int rows, int columns)
 {
     m_type = type;
     m_maxEdges = getMaxEdges(type);
     m_rows = rows;
     m_columns = columns;
-    m_graph.clear();
-    createNodes();
-    createEdges();
+    m_obstacles.assign(rows * columns, false);
+    initDirections();
+    updateMoves();
+}
+
+void Tiling::initDirections()
+{
+    for (int i = 0; i < NUMBER_DIRECTIONS; ++i)
+    {
+        m_directionOffset[i] = DIRECTION_ROW[i] * m_columns
+            + DIRECTION_COL[i];
+        if (i >= 4 && m_type == OCTILE)
+            m_directionCost[i] = COST_SQRT2;
+        else
+            m_directionCost[i] = COST_ONE;
+    }
+    // Pruning only depends on the relative positions and, for HEX, on the
+    // column parity, so it is computed for a node away from the borders
+    for (int parity = 0; parity < 2; ++parity)
+    {
+        int row = 2;
+        int col = 2 + parity;
+        for (int i = 0; i < NUMBER_DIRECTIONS; ++i)
+        {
+            int lastRow = row + DIRECTION_ROW[i];
+            int lastCol = col + DIRECTION_COL[i];
+            unsigned int pruned = 0;
+            for (int j = 0; j < NUMBER_DIRECTIONS; ++j)
+            {
+                int targetRow = row + DIRECTION_ROW[j];
+                int targetCol = col + DIRECTION_COL[j];
+                if ((targetRow == lastRow && targetCol == lastCol)
+                    || (m_type != TILE
+                        && isNeighbor(lastRow, lastCol, targetRow,
+                                      targetCol)))
+                    pruned |= (1 << j);
+            }
+            m_prunedMoves[parity][i] = pruned;
+        }
+    }
 }
 
 bool Tiling::isValidNodeId(int nodeId) const
@@ -567,21 +607,56 @@ void Tiling::printPathAndLabels(ostream& o, const vector<int>& path,
 }
 
 
+unsigned int Tiling::getPrunedMoves(int nodeId, int lastNodeId,
+                                    unsigned int moves) const
+{
+    int row = nodeId / m_columns;
+    int col = nodeId % m_columns;
+    int rowDiff = lastNodeId / m_columns - row;
+    int colDiff = lastNodeId % m_columns - col;
+    if (abs(rowDiff) <= 1 && abs(colDiff) <= 1 && lastNodeId != nodeId)
+        return m_prunedMoves[col % 2][DIRECTION_INDEX[rowDiff + 1]
+                                                     [colDiff + 1]];
+    // Last node is not adjacent, check each move
+    unsigned int pruned = 0;
+    for (int i = 0; i < NUMBER_DIRECTIONS; ++i)
+        if ((moves & (1 << i)) != 0
+            && pruneNode(nodeId + m_directionOffset[i], lastNodeId))
+            pruned |= (1 << i);
+    return pruned;
+}
+
+bool Tiling::isNeighbor(int row, int col, int targetRow, int targetCol)
+    const
+{
+    int rowDiff = targetRow - row;
+    int colDiff = targetCol - col;
+    if (abs(rowDiff) > 1 || abs(colDiff) > 1
+        || (rowDiff == 0 && colDiff == 0))
+        return false;
+    switch (m_type)
+    {
+    case OCTILE:
+    case OCTILE_UNICOST:
+        return true;
+    case HEX:
+        return (rowDiff == 0 || colDiff == 0
+                || rowDiff == (col % 2 == 0 ? -1 : 1));
+    case TILE:
+        return (rowDiff == 0 || colDiff == 0);
+    }
+    assert(false);
+    return false;
+}
+
 bool Tiling::pruneNode(int targetNodeId, int lastNodeId) const
 {
     if (targetNodeId == lastNodeId)
         return true;
     if (m_type == TILE)
         return false;
-    const TilingNode& lastNode = m_graph.getNode(lastNodeId);
-    const vector<TilingEdge>& edges = lastNode.getOutEdges(); 
-    for (vector<TilingEdge>::const_iterator i = edges.begin();
-         i != edges.end(); ++i)
-    {
-        if (i->getTargetNodeId() == targetNodeId)
-            return true;
-    }
-    return false;
+    return isNeighbor(lastNodeId / m_columns, lastNodeId % m_columns,
+                      targetNodeId / m_columns, targetNodeId % m_columns);
 }
 
 void Tiling::readObstacles(LineReader& reader)
@@ -592,24 +667,23 @@ void Tiling::readObstacles(LineReader& reader)
         istringstream in(line);
         for (int col = 0; col < m_columns; ++col)
         {
-            bool isObstacle;
+            bool obstacle;
             char c;
             in.get(c);
             if (! in)
                 throw reader.createError("Unexpected end of stream.");
             if (c == '@')
-                isObstacle = true;
+                obstacle = true;
             else if (c == '.')
             {
-                isObstacle = false;
+                obstacle = false;
                 m_storageStatistics.get("nodes").add(1);
             }
             else
                 throw reader.createError("Unknown charcter.");
             int nodeId = getNodeId(row, col);
-            TilingNodeInfo& nodeInfo = m_graph.getNodeInfo(nodeId);
-            if (! nodeInfo.isObstacle())
-                nodeInfo.setObstacle(isObstacle);
+            if (! m_obstacles[nodeId])
+                m_obstacles[nodeId] = obstacle;
             
         }
     }
@@ -628,10 +702,10 @@ bool Tiling::conflictDiag(int row, int col, int roff, int coff)
          (col+coff < 0) || (col+coff >= m_columns) )
         return false;
 
-    if ( (m_graph.getNodeInfo(getNodeId(row+roff,col+coff))).isObstacle() )
+    if ( isObstacle(getNodeId(row+roff,col+coff)) )
     {
-        if ( !m_graph.getNodeInfo(getNodeId(row,col+coff)).isObstacle() &&
-             !m_graph.getNodeInfo(getNodeId(row+roff,col)).isObstacle() )
+        if ( !isObstacle(getNodeId(row,col+coff)) &&
+             !isObstacle(getNodeId(row+roff,col)) )
         return true;
     }
     return false;
@@ -640,39 +714,48 @@ bool Tiling::conflictDiag(int row, int col, int roff, int coff)
 
 void Tiling::setObstacles(float obstaclePercentage, bool avoidDiag )
 {
-    clearObstacles();
+    m_obstacles.assign(getNumberNodes(), false);
     int numberNodes = getNumberNodes();
     int numberObstacles = static_cast<int>(obstaclePercentage * numberNodes);
     for (int count = 0; count < numberObstacles; )
     {
         int nodeId = rand() / (RAND_MAX / numberNodes + 1);
-        TilingNodeInfo& nodeInfo = m_graph.getNodeInfo(nodeId);
-        if (! nodeInfo.isObstacle())
+        if (! isObstacle(nodeId))
         {
             if ( avoidDiag )
             {
-                int row = nodeInfo.getRow();
-                int col = nodeInfo.getColumn();
+                int row = nodeId / m_columns;
+                int col = nodeId % m_columns;
 
                 if ( !conflictDiag(row,col,-1,-1) && 
                      !conflictDiag(row,col,-1,+1) &&
                      !conflictDiag(row,col,+1,-1) &&
                      !conflictDiag(row,col,+1,+1) )
                 {
-                    nodeInfo.setObstacle(true);
+                    m_obstacles[nodeId] = true;
                     ++count;
                 }
             }
             else 
             {
-                nodeInfo.setObstacle(true);
+                m_obstacles[nodeId] = true;
                 ++count;
             }
         }
     }
+    updateMoves();
 }
 
-int Tiling::getPathCost(const vector<int> &path)
+void Tiling::setObstacle(int nodeId, bool isObstacle)
+{
+    assert(isValidNodeId(nodeId));
+    if (m_obstacles[nodeId] == isObstacle)
+        return;
+    m_obstacles[nodeId] = isObstacle;
+    updateMoves(nodeId / m_columns, nodeId % m_columns);
+}
+
+int Tiling::getPathCost(const vector<int> &path) const
 {
     int cost = 0;
     switch (m_type)
@@ -709,6 +792,21 @@ bool Tiling::areAligned(int p1, int p2) const
     return false;
 }
 
+void Tiling::updateMoves()
+{
+    m_moves.resize(getNumberNodes());
+    for (int row = 0; row < m_rows; ++row)
+        for (int col = 0; col < m_columns; ++col)
+            m_moves[getNodeId(row, col)] = computeMoves(row, col);
+}
+
+void Tiling::updateMoves(int row, int col)
+{
+    for (int r = max(0, row - 1); r <= min(m_rows - 1, row + 1); ++r)
+        for (int c = max(0, col - 1); c <= min(m_columns - 1, col + 1); ++c)
+            m_moves[getNodeId(r, c)] = computeMoves(r, c);
+}
+
 bool Tiling::canJump(int p1, int p2) const
 {
     if (m_type != Tiling::OCTILE && m_type != Tiling::OCTILE_UNICOST)
@@ -717,11 +815,86 @@ bool Tiling::canJump(int p1, int p2) const
         return true;
     int nodeId12 = getNodeId(p1/getWidth(), p2%getWidth());
     int nodeId21 = getNodeId(p2/getWidth(), p1%getWidth());
-    const TilingNodeInfo& nodeInfo12 = m_graph.getNodeInfo(nodeId12);
-    const TilingNodeInfo& nodeInfo21 = m_graph.getNodeInfo(nodeId21);
-    if (nodeInfo12.isObstacle() && nodeInfo21.isObstacle())
+    if (isObstacle(nodeId12) && isObstacle(nodeId21))
         return false;
     return true;
 }
 
 //-----------------------------------------------------------------------------
+
+TilingWindow::TilingWindow(const Tiling& tiling, int horizOrigin,
+                           int vertOrigin, int width, int height)
+    : m_tiling(&tiling),
+      m_horizOrigin(horizOrigin),
+      m_vertOrigin(vertOrigin),
+      m_width(width),
+      m_height(height),
+      m_originId(tiling.getNodeId(vertOrigin, horizOrigin))
+{
+    assert(width > 0 && horizOrigin + width <= tiling.getWidth());
+    assert(height > 0 && vertOrigin + height <= tiling.getHeight());
+    for (int i = 0; i < Tiling::NUMBER_DIRECTIONS; ++i)
+        m_directionOffset[i] = DIRECTION_ROW[i] * width + DIRECTION_COL[i];
+}
+
+int TilingWindow::getHeuristic(int start, int target) const
+{
+    return m_tiling->getHeuristic(getGlobalId(start), getGlobalId(target));
+}
+
+int TilingWindow::getMaxCost() const
+{
+    return m_tiling->getMaxCost();
+}
+
+int TilingWindow::getMinCost() const
+{
+    return m_tiling->getMinCost();
+}
+
+int TilingWindow::getNumberNodes() const
+{
+    return m_width * m_height;
+}
+
+void TilingWindow::getSuccessors(int nodeId, int lastNodeId,
+                                 vector<Successor>& result) const
+{
+    result.reserve(m_tiling->m_maxEdges);
+    result.clear();
+    SuccessorCollector collector(result);
+    visitSuccessors(nodeId, lastNodeId, collector);
+}
+
+bool TilingWindow::isValidNodeId(int nodeId) const
+{
+    return nodeId >= 0 && nodeId < getNumberNodes();
+}
+
+void TilingWindow::visitSuccessors(int nodeId, int lastNodeId,
+                                   SuccessorVisitor& visitor) const
+{
+    int row = nodeId / m_width;
+    int col = nodeId % m_width;
+    int globalId = m_originId + row * m_tiling->m_columns + col;
+    unsigned int moves = m_tiling->m_moves[globalId];
+    // Remove the moves that leave the window
+    if (row == 0)
+        moves &= ~MOVES_NORTH;
+    if (row == m_height - 1)
+        moves &= ~MOVES_SOUTH;
+    if (col == 0)
+        moves &= ~MOVES_WEST;
+    if (col == m_width - 1)
+        moves &= ~MOVES_EAST;
+    if (lastNodeId != NO_NODE && moves != 0)
+        moves &= ~m_tiling->getPrunedMoves(globalId, getGlobalId(lastNodeId),
+                                           moves);
+    for (int i = 0; moves != 0; ++i, moves >>= 1)
+        if ((moves & 1) != 0
+            && ! visitor.visit(nodeId + m_directionOffset[i],
+                               m_tiling->m_directionCost[i]))
+            return;
+}
+
+//-----------------------------------------------------------------------------
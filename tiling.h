@@ -22,24 +22,9 @@ namespace PathFind
 
     const int COST_SQRT2 = 142;
 
-    class TilingEdgeInfo
-    {
-    public:
-        TilingEdgeInfo(int cost)
-            : m_cost(cost)
-        {
-            assert(cost == COST_ONE || cost == COST_SQRT2);
-        }
-
-        int getCost() const
-        {
-            return m_cost;
-        }
-
-    private:
-        int m_cost;
-    };
-    
+    /** Information about a node of a Tiling.
+        Not stored in the tiling, but returned by Tiling::getNodeInfo.
+    */
     class TilingNodeInfo
     {
     public:
@@ -75,10 +60,23 @@ namespace PathFind
         int m_row;
     };
 
+    class TilingWindow;
+
+    /** Grid map with obstacles.
+        The graph is implicit: the obstacles are stored in a bit vector,
+        the neighbors of a node and the costs of the edges are computed
+        from the row and column of the node and the type of the tiling.
+        A node id is row * width + column.
+        The legal moves of each node are kept in a bit mask, which is
+        updated when obstacles change, so that generating the successors
+        does not need to look at the neighbors.
+    */
     class Tiling
         : public Environment
     {
     public:
+        friend class TilingWindow;
+
         typedef enum {
             HEX,
 
@@ -91,6 +89,9 @@ namespace PathFind
             TILE
         } Type;
 
+        /** Number of move directions, see getMoves(). */
+        static const int NUMBER_DIRECTIONS = 8;
+
         Tiling(Type type, int rows, int columns);
 
         Tiling(const Tiling & tiling, int horizOrigin, int vertOrigin, int width, int height);
@@ -119,6 +120,9 @@ namespace PathFind
         void getSuccessors(int nodeId, int lastNodeId,
                            vector<Successor>& result) const;
 
+        void visitSuccessors(int nodeId, int lastNodeId,
+                             SuccessorVisitor& visitor) const;
+
         bool isValidNodeId(int nodeId) const;
 
         void printFormatted(ostream& o) const;
@@ -148,17 +152,48 @@ namespace PathFind
             return m_rows;
         }
 
-        TilingNodeInfo & getNodeInfo(int nodeId) const
+        TilingNodeInfo getNodeInfo(int nodeId) const
+        {
+            return TilingNodeInfo(isObstacle(nodeId), nodeId / m_columns,
+                                  nodeId % m_columns);
+        }
+
+        bool isObstacle(int nodeId) const
+        {
+            assert(isValidNodeId(nodeId));
+            return m_obstacles[nodeId];
+        }
+
+        /** Get the node id offset of a move direction. */
+        int getDirectionOffset(int direction) const
+        {
+            assert(direction >= 0 && direction < NUMBER_DIRECTIONS);
+            return m_directionOffset[direction];
+        }
+
+        /** Get the legal moves of a node.
+            Bit i is set if the move in direction i is an edge of the
+            tiling. The directions are N, S, W, E, SE, SW, NE, NW, which
+            is the order of the successors; the diagonal directions have
+            the indices 4 to 7. Obstacles have no moves.
+        */
+        unsigned int getMoves(int nodeId) const
         {
-            return (TilingNodeInfo &)m_graph.getNodeInfo(nodeId);
+            assert(isValidNodeId(nodeId));
+            return m_moves[nodeId];
         }
 
+        /** Set or clear an obstacle.
+            Updates the moves of the node and its neighbors.
+        */
+        void setObstacle(int nodeId, bool isObstacle);
+
         Type getType() const
         {
             return m_type;
         }
 
-        int getPathCost(const vector<int> &path);
+        int getPathCost(const vector<int> &path) const;
 
         bool canJump(int p1, int p2) const;
 
@@ -169,13 +204,6 @@ namespace PathFind
         StatisticsCollection createStorageStatistics();
 
     private:
-        typedef Graph<TilingNodeInfo, TilingEdgeInfo>::Edge TilingEdge;
-
-        typedef Graph<TilingNodeInfo, TilingEdgeInfo> TilingGraph;
-
-        typedef Graph<TilingNodeInfo, TilingEdgeInfo>::Node TilingNode;
-
-
         int m_columns;
 
         int m_maxEdges;
@@ -184,17 +212,32 @@ namespace PathFind
 
         Type m_type;
 
-        TilingGraph m_graph;
+        /** Obstacle flag for each node. */
+        vector<bool> m_obstacles;
 
-        StatisticsCollection m_storageStatistics;
+        /** Legal moves of each node.
+            A move is legal if it is an edge of the tiling type, leads to
+            a node on the map that is not an obstacle, and is not a
+            diagonal move between two obstacles.
+            @see getMoves
+        */
+        vector<unsigned char> m_moves;
 
-        void addOutEdge(int nodeId, int row, int col, int cost);
+        /** Node id offset of each direction. */
+        int m_directionOffset[NUMBER_DIRECTIONS];
 
-        bool conflictDiag(int row, int col, int roff, int coff );
+        /** Edge cost of each direction. */
+        int m_directionCost[NUMBER_DIRECTIONS];
+
+        /** Moves pruned if the last node is adjacent to the node.
+            Indexed by the column parity of the node and the direction
+            from the node to the last node.
+        */
+        unsigned char m_prunedMoves[2][NUMBER_DIRECTIONS];
 
-        void createEdges();
+        StatisticsCollection m_storageStatistics;
 
-        void createNodes();
+        bool conflictDiag(int row, int col, int roff, int coff );
 
         vector<char> getCharVector() const;
 
@@ -204,6 +247,27 @@ namespace PathFind
 
         void printFormatted(ostream& o, const vector<char>& chars) const;
 
+        /** Compute the legal moves of a node, see m_moves. */
+        unsigned int computeMoves(int row, int col) const;
+
+        /** Get the moves of a node that lead to the last node or its
+            neighbors.
+            @param moves Legal moves of the node.
+        */
+        unsigned int getPrunedMoves(int nodeId, int lastNodeId,
+                                    unsigned int moves) const;
+
+        /** Initialize the direction tables for the tiling type and the
+            number of columns.
+        */
+        void initDirections();
+
+        /** Check if there is an edge from a position to another position,
+            ignoring obstacles and the borders of the map.
+        */
+        bool isNeighbor(int row, int col, int targetRow, int targetCol)
+            const;
+
         bool pruneNode(int targetNodeId, int lastNodeId) const;
 
         void readObstacles(LineReader& reader);
@@ -212,6 +276,105 @@ namespace PathFind
 
         void countRealEdges();
 
+        /** Compute the moves of all nodes. */
+        void updateMoves();
+
+        /** Compute the moves of a node and its neighbors. */
+        void updateMoves(int row, int col);
+
+    };
+
+    /** Rectangular part of a Tiling used as an environment.
+        Does not copy the tiling, but reads its obstacles and moves, so
+        the tiling must outlive the window. Node ids are local to the
+        window (row * width + column, relative to the origin).
+        The window has the same nodes and edges as a Tiling constructed
+        from the part of the map, except for HEX with an odd horizontal
+        origin, where the edges follow the column parity of the parent
+        tiling.
+    */
+    class TilingWindow
+        : public Environment
+    {
+    public:
+        TilingWindow(const Tiling& tiling, int horizOrigin, int vertOrigin,
+                     int width, int height);
+
+        int getGlobalId(int localId) const
+        {
+            assert(isValidNodeId(localId));
+            return m_originId + (localId / m_width) * m_tiling->m_columns
+                + localId % m_width;
+        }
+
+        int getHeight() const
+        {
+            return m_height;
+        }
+
+        int getHeuristic(int start, int target) const;
+
+        int getHorizOrigin() const
+        {
+            return m_horizOrigin;
+        }
+
+        /** Get the local id of a node of the tiling inside the window. */
+        int getLocalId(int globalId) const
+        {
+            int row = globalId / m_tiling->m_columns - m_vertOrigin;
+            int col = globalId % m_tiling->m_columns - m_horizOrigin;
+            assert(row >= 0 && row < m_height);
+            assert(col >= 0 && col < m_width);
+            return row * m_width + col;
+        }
+
+        int getMaxCost() const;
+
+        int getMinCost() const;
+
+        int getNumberNodes() const;
+
+        void getSuccessors(int nodeId, int lastNodeId,
+                           vector<Successor>& result) const;
+
+        const Tiling& getTiling() const
+        {
+            return *m_tiling;
+        }
+
+        int getVertOrigin() const
+        {
+            return m_vertOrigin;
+        }
+
+        int getWidth() const
+        {
+            return m_width;
+        }
+
+        bool isValidNodeId(int nodeId) const;
+
+        void visitSuccessors(int nodeId, int lastNodeId,
+                             SuccessorVisitor& visitor) const;
+
+    private:
+        /** Parent tiling, a pointer so that windows can be assigned. */
+        const Tiling* m_tiling;
+
+        int m_horizOrigin;
+
+        int m_vertOrigin;
+
+        int m_width;
+
+        int m_height;
+
+        /** Id of the origin in the tiling. */
+        int m_originId;
+
+        /** Local id offset of each direction, see Tiling::m_moves. */
+        int m_directionOffset[Tiling::NUMBER_DIRECTIONS];
     };
 }
 
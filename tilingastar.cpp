@@ -0,0 +1,112 @@
+//-----------------------------------------------------------------------------
+/** @file tilingastar.cpp
+    @see tilingastar.h
+*/
+//-----------------------------------------------------------------------------
+
+#include "tilingastar.h"
+
+#include <time.h>
+#include "error.h"
+
+using namespace std;
+using namespace PathFind;
+
+//-----------------------------------------------------------------------------
+
+TilingAStar::TilingAStar()
+    : m_isAborted(false),
+      m_numberNodes(0),
+      m_pathCost(-1),
+      m_nodesExpanded(0),
+      m_nodesVisited(0),
+      m_statistics(createStatistics()),
+      m_branchingFactor(m_statistics.get("branching_factor")),
+      m_cpuTimeStatistics(m_statistics.get("cpu_time")),
+      m_nodesExpandedStatistics(m_statistics.get("nodes_expanded")),
+      m_nodesVisitedStatistics(m_statistics.get("nodes_visited")),
+      m_openLengthStatistics(m_statistics.get("open_length")),
+      m_openMaxStatistics(m_statistics.get("open_max")),
+      m_pathCostStatistics(m_statistics.get("path_cost")),
+      m_pathLengthStatistics(m_statistics.get("path_length"))
+{
+}
+
+StatisticsCollection TilingAStar::createStatistics()
+{
+    return createBasicStatistics();
+}
+
+bool TilingAStar::findPath(const Environment& env, int start, int target)
+{
+    const Tiling* tiling = dynamic_cast<const Tiling*>(&env);
+    if (tiling == 0)
+        throw Error("TilingAStar needs a Tiling environment.");
+    assert(env.isValidNodeId(start));
+    assert(env.isValidNodeId(target));
+    clock_t startTime = clock();
+    m_statistics.clear();
+    m_numberNodes = env.getNumberNodes();
+    clearTrace();
+    switch (tiling->getType())
+    {
+    case Tiling::OCTILE:
+        runSearch(m_octileSearch,
+                  TilingEnvironment<Tiling::OCTILE>(*tiling), start, target);
+        break;
+    case Tiling::OCTILE_UNICOST:
+        runSearch(m_octileUnicostSearch,
+                  TilingEnvironment<Tiling::OCTILE_UNICOST>(*tiling),
+                  start, target);
+        break;
+    case Tiling::TILE:
+        runSearch(m_tileSearch,
+                  TilingEnvironment<Tiling::TILE>(*tiling), start, target);
+        break;
+    default:
+        runSearch(m_otherSearch, EnvironmentAdapter<Tiling>(*tiling),
+                  start, target);
+        break;
+    }
+    double timeDiff =
+        static_cast<double>(clock() - startTime) / CLOCKS_PER_SEC;
+    m_cpuTimeStatistics.add(timeDiff);
+    if (m_pathCost >= 0)
+        m_pathCostStatistics.add(m_pathCost);
+    m_nodesExpandedStatistics.add(m_nodesExpanded);
+    m_nodesVisitedStatistics.add(m_nodesVisited);
+    m_pathLengthStatistics.add(m_path.size());
+    return ! m_isAborted;
+}
+
+const StatisticsCollection& TilingAStar::getStatistics() const
+{
+    return m_statistics;
+}
+
+const vector<char>& TilingAStar::getVisitedNodes() const
+{
+    return getVisitedNodeLabels(m_numberNodes);
+}
+
+template<class SEARCH, class ENV>
+void TilingAStar::runSearch(SEARCH& search, const ENV& env, int start,
+                            int target)
+{
+    search.setTracing(getTraceMode() == TRACE_VISITED);
+    search.setNodesLimit(m_nodesLimit);
+    m_pathCost = search.findPath(env, start, target);
+    m_isAborted = search.isAborted();
+    m_path = search.getPath();
+    m_nodesExpanded = search.getNodesExpanded();
+    m_nodesVisited = search.getNodesVisited();
+    m_branchingFactor.add(search.getBranchingFactor());
+    m_openLengthStatistics.add(search.getOpenLength());
+    m_openMaxStatistics.add(search.getOpenMax());
+    const vector<int>& visitedNodeIds = search.getVisitedNodeIds();
+    for (vector<int>::const_iterator i = visitedNodeIds.begin();
+         i != visitedNodeIds.end(); ++i)
+        traceVisited(*i);
+}
+
+//-----------------------------------------------------------------------------
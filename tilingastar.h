@@ -0,0 +1,212 @@
+//-----------------------------------------------------------------------------
+/** @file tilingastar.h
+    A* search specialized for the tiling types.
+*/
+//-----------------------------------------------------------------------------
+
+#ifndef PATHFIND_TILINGASTAR_H
+#define PATHFIND_TILINGASTAR_H
+
+#include <stdlib.h>
+#include "basicastar.h"
+#include "search.h"
+#include "tiling.h"
+
+//-----------------------------------------------------------------------------
+
+namespace PathFind
+{
+    using namespace std;
+
+    /** Heuristic of Tiling::getHeuristic for a tiling type known at
+        compile time.
+        Only specialized for OCTILE, OCTILE_UNICOST and TILE.
+    */
+    template<Tiling::Type TYPE>
+    class TilingHeuristic
+    {
+    public:
+        template<class ENV>
+        int operator()(const ENV& env, int nodeId, int target) const
+        {
+            int columns = env.getColumns();
+            int diffCol = abs(target % columns - nodeId % columns);
+            int diffRow = abs(target / columns - nodeId / columns);
+            return getDistance(diffRow, diffCol);
+        }
+
+        static int getDistance(int diffRow, int diffCol);
+    };
+
+    template<>
+    inline int TilingHeuristic<Tiling::OCTILE>::getDistance(int diffRow,
+                                                            int diffCol)
+    {
+        if (diffCol > diffRow)
+            return diffRow * COST_SQRT2 + (diffCol - diffRow) * COST_ONE;
+        return diffCol * COST_SQRT2 + (diffRow - diffCol) * COST_ONE;
+    }
+
+    template<>
+    inline int
+    TilingHeuristic<Tiling::OCTILE_UNICOST>::getDistance(int diffRow,
+                                                         int diffCol)
+    {
+        return max(diffCol, diffRow) * COST_ONE;
+    }
+
+    template<>
+    inline int TilingHeuristic<Tiling::TILE>::getDistance(int diffRow,
+                                                          int diffCol)
+    {
+        return (diffCol + diffRow) * COST_ONE;
+    }
+
+    /** Environment for BasicAStar on a Tiling of a type known at compile
+        time.
+        Generates the same successors in the same order as
+        Tiling::visitSuccessors from the move masks of the tiling, but with
+        the edge costs and the visitor known at compile time.
+    */
+    template<Tiling::Type TYPE>
+    class TilingEnvironment
+    {
+    public:
+        typedef TilingHeuristic<TYPE> Heuristic;
+
+        explicit TilingEnvironment(const Tiling& tiling)
+            : m_columns(tiling.getWidth()),
+              m_numberNodes(tiling.getNumberNodes()),
+              m_tiling(tiling)
+        {
+            assert(tiling.getType() == TYPE);
+            for (int i = 0; i < Tiling::NUMBER_DIRECTIONS; ++i)
+                m_directionOffset[i] = tiling.getDirectionOffset(i);
+        }
+
+        int getColumns() const
+        {
+            return m_columns;
+        }
+
+        int getNumberNodes() const
+        {
+            return m_numberNodes;
+        }
+
+        template<class VISITOR>
+        void visitSuccessors(int nodeId, VISITOR& visitor) const
+        {
+            unsigned int moves = m_tiling.getMoves(nodeId);
+            for (int i = 0; moves != 0; ++i, moves >>= 1)
+                if ((moves & 1) != 0
+                    && ! visitor.visit(nodeId + m_directionOffset[i],
+                                       getCost(i)))
+                    return;
+        }
+
+    private:
+        int m_columns;
+
+        int m_numberNodes;
+
+        const Tiling& m_tiling;
+
+        int m_directionOffset[Tiling::NUMBER_DIRECTIONS];
+
+        static int getCost(int direction)
+        {
+            if (TYPE == Tiling::OCTILE && direction >= 4)
+                return COST_SQRT2;
+            return COST_ONE;
+        }
+    };
+
+    /** Search engine using BasicAStar instantiated for the type of the
+        tiling.
+        Finds the same paths and collects the same statistics as AStar,
+        so it can replace AStar on tilings. Tilings of type HEX use the
+        functions of Tiling without virtual calls, but not inlined.
+        Only supports Tiling; the searches on the abstract graphs of
+        HTiling use AStar.
+    */
+    class TilingAStar
+        : public Search
+    {
+    public:
+        TilingAStar();
+
+        StatisticsCollection createStatistics();
+
+        /** Find a path.
+            @return false, if search was aborted due to node limit.
+            @throws Error, if the environment is not a Tiling.
+        */
+        bool findPath(const Environment& env, int start, int target);
+
+        const vector<int>& getPath() const
+        {
+            return m_path;
+        }
+
+        int getPathCost() const
+        {
+            return m_pathCost;
+        }
+
+        const StatisticsCollection& getStatistics() const;
+
+        /** Get a vector with '+' char labels for each visited node.
+            @see Search::getVisitedNodes
+        */
+        const vector<char>& getVisitedNodes() const;
+
+    private:
+        bool m_isAborted;
+
+        int m_numberNodes;
+
+        int m_pathCost;
+
+        long long int m_nodesExpanded;
+
+        long long int m_nodesVisited;
+
+        BasicAStar<TilingEnvironment<Tiling::OCTILE> > m_octileSearch;
+
+        BasicAStar<TilingEnvironment<Tiling::OCTILE_UNICOST> >
+            m_octileUnicostSearch;
+
+        BasicAStar<TilingEnvironment<Tiling::TILE> > m_tileSearch;
+
+        BasicAStar<EnvironmentAdapter<Tiling> > m_otherSearch;
+
+        vector<int> m_path;
+
+        StatisticsCollection m_statistics;
+
+        Statistics& m_branchingFactor;
+
+        Statistics& m_cpuTimeStatistics;
+
+        Statistics& m_nodesExpandedStatistics;
+
+        Statistics& m_nodesVisitedStatistics;
+
+        Statistics& m_openLengthStatistics;
+
+        Statistics& m_openMaxStatistics;
+
+        Statistics& m_pathCostStatistics;
+
+        Statistics& m_pathLengthStatistics;
+
+        template<class SEARCH, class ENV>
+        void runSearch(SEARCH& search, const ENV& env, int start,
+                       int target);
+    };
+}
+
+//-----------------------------------------------------------------------------
+
+#endif